@@ -0,0 +1,139 @@
+/*
+  FILE: BlockReader.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 09:12:40 PDT 2026
+*/
+
+//
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph and Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef BLOCK_READER_HPP
+#define BLOCK_READER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Formats.hpp"
+#include "SPSCQueue.hpp"
+
+namespace Ext
+{
+
+  //==============================================================================
+  // BlockReader<T>
+  //  Parses whitespace-separated values of type T from a FILE* on a dedicated
+  //  thread.  Parsed values are handed to the (single) consumer in fixed-size
+  //  blocks through a bounded SPSCQueue.  Only 'numBlocks' blocks ever exist, so
+  //  the reader thread waits whenever the consumer falls behind.
+  //  Next() gives access to the next block of values, which remains valid until
+  //  the following call to Next().  Failed() is meaningful once Next() returns
+  //  false, and indicates the input could not be parsed as a series of T's.
+  //==============================================================================
+  template <typename T>
+  class BlockReader {
+  public:
+    explicit BlockReader(FILE* in, std::size_t blockValues = 65536, std::size_t numBlocks = 4)
+      : in_(in), blockValues_(blockValues), work_(numBlocks + 1), free_(numBlocks + 1),
+        held_(0), done_(false), failed_(false), stop_(false) {
+
+      for ( std::size_t i = 0; i < numBlocks; ++i ) {
+        all_.push_back(new std::vector<T>());
+        all_.back()->reserve(blockValues_);
+        free_.Push(all_.back());
+      } // for
+      thread_ = std::thread(&BlockReader::run, this);
+    }
+
+    bool Next(std::vector<T>*& blk) {
+      if ( held_ )
+        free_.Push(held_), held_ = 0;
+      if ( done_ )
+        return(false);
+
+      work_.Pop(held_);
+      if ( !held_ ) { // end of input
+        done_ = true;
+        return(false);
+      }
+      blk = held_;
+      return(true);
+    }
+
+    bool Failed() const
+      { return(failed_.load()); }
+
+    ~BlockReader() {
+      stop_.store(true);
+      std::vector<T>* blk = held_;
+      while ( !done_ ) { // drain so the reader thread can finish
+        if ( blk )
+          free_.Push(blk);
+        work_.Pop(blk);
+        done_ = (blk == 0);
+      } // while
+      thread_.join();
+      for ( std::size_t i = 0; i < all_.size(); ++i )
+        delete all_[i];
+    }
+
+  private:
+    BlockReader(const BlockReader&); // not copyable
+    BlockReader& operator=(const BlockReader&);
+
+    void run() {
+      const std::string f = Formats::Format(T()) + std::string("\n");
+      char const* format = f.c_str();
+      std::vector<T>* blk = 0;
+      T d;
+      free_.Pop(blk);
+      blk->clear();
+      while ( !std::feof(in_) && !stop_.load() ) { // read the whole file
+        if ( 1 != std::fscanf(in_, format, &d) ) {
+          failed_.store(true);
+          break;
+        }
+        blk->push_back(d);
+        if ( blk->size() == blockValues_ ) {
+          work_.Push(blk);
+          free_.Pop(blk);
+          blk->clear();
+        }
+      } // while
+      work_.Push(blk);
+      work_.Push(static_cast<std::vector<T>*>(0)); // end of input
+    }
+
+  private:
+    FILE* in_;
+    const std::size_t blockValues_;
+    std::vector< std::vector<T>* > all_;
+    SPSCQueue< std::vector<T>* > work_, free_;
+    std::vector<T>* held_;
+    bool done_;
+    std::atomic<bool> failed_, stop_;
+    std::thread thread_;
+  };
+
+} // namespace Ext
+
+#endif // BLOCK_READER_HPP
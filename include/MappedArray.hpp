@@ -0,0 +1,203 @@
+/*
+  FILE: MappedArray.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 12:20:51 PDT 2026
+*/
+
+//
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph and Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef MAPPED_ARRAY_HPP
+#define MAPPED_ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Ext
+{
+
+  //==============================================================================
+  // MappedArray<T>
+  //  A contiguous, growable array of trivially copyable T's backed by an
+  //  anonymous memory mapping.  Growth uses mremap(), which moves page table
+  //  entries rather than copying data, so appending N values never needs the
+  //  old and the new storage to be resident at once.  Untouched capacity is
+  //  only reserved address space and costs no RAM.
+  //  Provides the subset of std::vector<T> used by the wavelet library, so it
+  //  may be used as a Sequence anywhere a vector<T> is expected.
+  //==============================================================================
+  template <typename T>
+  class MappedArray {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedArray requires trivially copyable T");
+
+  public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::size_t size_type;
+
+    MappedArray() : data_(0), size_(0), cap_(0)
+      { /* */ }
+
+    explicit MappedArray(std::size_t n, const T& t = T()) : data_(0), size_(0), cap_(0)
+      { resize(n, t); }
+
+    MappedArray(const MappedArray& other) : data_(0), size_(0), cap_(0)
+      { append(other.data_, other.size_); }
+
+    MappedArray& operator=(const MappedArray& other) {
+      if ( this != &other ) {
+        size_ = 0;
+        append(other.data_, other.size_);
+      }
+      return(*this);
+    }
+
+    ~MappedArray()
+      { release(); }
+
+    inline void push_back(const T& t) {
+      if ( size_ == cap_ )
+        grow(size_ + 1);
+      data_[size_++] = t;
+    }
+
+    void append(const T* vals, std::size_t n) {
+      if ( size_ + n > cap_ )
+        grow(size_ + n);
+      if ( n )
+        std::memcpy(data_ + size_, vals, n * sizeof(T));
+      size_ += n;
+    }
+
+    void resize(std::size_t n, const T& t = T()) {
+      if ( n > cap_ )
+        grow(n);
+      if ( n > size_ )
+        std::fill(data_ + size_, data_ + n, t);
+      size_ = n;
+    }
+
+    void reserve(std::size_t n) {
+      if ( n > cap_ )
+        grow(n);
+    }
+
+    void clear()
+      { size_ = 0; }
+
+    void swap(MappedArray& other) {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(cap_, other.cap_);
+    }
+
+    inline T& operator[](std::size_t i)
+      { return(data_[i]); }
+
+    inline const T& operator[](std::size_t i) const
+      { return(data_[i]); }
+
+    std::size_t size() const
+      { return(size_); }
+
+    bool empty() const
+      { return(size_ == 0); }
+
+    T* data()
+      { return(data_); }
+
+    const T* data() const
+      { return(data_); }
+
+    iterator begin()
+      { return(data_); }
+
+    iterator end()
+      { return(data_ + size_); }
+
+    const_iterator begin() const
+      { return(data_); }
+
+    const_iterator end() const
+      { return(data_ + size_); }
+
+  private:
+    static std::size_t bytes(std::size_t n) {
+#ifdef __linux__
+      static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+      return(((n * sizeof(T) + page - 1) / page) * page);
+#else
+      return(n * sizeof(T));
+#endif
+    }
+
+    void grow(std::size_t minCap) {
+      // doubling only reserves address space ; pages are populated on first touch
+      static const std::size_t initial = (std::size_t(1) << 20) / sizeof(T);
+      std::size_t cap = std::max(std::max(minCap, 2 * cap_), initial);
+      void* mem = 0;
+#ifdef __linux__
+      if ( !data_ )
+        mem = ::mmap(0, bytes(cap), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      else
+        mem = ::mremap(data_, bytes(cap_), bytes(cap), MREMAP_MAYMOVE);
+      if ( mem == MAP_FAILED )
+        throw(std::bad_alloc());
+      cap = bytes(cap) / sizeof(T);
+#else
+      mem = std::realloc(data_, bytes(cap));
+      if ( !mem )
+        throw(std::bad_alloc());
+#endif
+      data_ = static_cast<T*>(mem);
+      cap_ = cap;
+    }
+
+    void release() {
+      if ( !data_ )
+        return;
+#ifdef __linux__
+      ::munmap(data_, bytes(cap_));
+#else
+      std::free(data_);
+#endif
+      data_ = 0;
+      size_ = cap_ = 0;
+    }
+
+  private:
+    T* data_;
+    std::size_t size_, cap_;
+  };
+
+} // namespace Ext
+
+#endif // MAPPED_ARRAY_HPP
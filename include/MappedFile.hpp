@@ -0,0 +1,148 @@
+/*
+  FILE: MappedFile.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 21:40:12 PDT 2026
+*/
+
+//
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph and Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+
+namespace Ext
+{
+
+  //==============================================================================
+  // MappedFile<T>
+  //  A read-only view of a file of native binary T's, such as those written
+  //  with --binary.  The file is mapped rather than read, so its pages are
+  //  brought in as they are touched and nothing is copied.  The file size
+  //  must be a whole number of T's.
+  //  Provides the read-only subset of std::vector<T> used by the wavelet
+  //  library, so it may be used wherever coefficients are only read.
+  //==============================================================================
+  template <typename T>
+  class MappedFile {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedFile requires trivially copyable T");
+
+  public:
+    typedef T value_type;
+    typedef const T& const_reference;
+    typedef const T* const_iterator;
+    typedef std::size_t size_type;
+
+    explicit MappedFile(const std::string& name) : data_(0), size_(0), bytes_(0) {
+      const int fd = ::open(name.c_str(), O_RDONLY);
+      Ext::Assert<Ext::InvalidFile>(fd >= 0, "Unable to open file for reading: " + name);
+      struct stat st;
+      const bool ok = (0 == ::fstat(fd, &st)) && st.st_size > 0 && (st.st_size % sizeof(T)) == 0;
+      if ( ok )
+        map(fd, static_cast<std::size_t>(st.st_size));
+      ::close(fd);
+      Ext::Assert<Ext::InvalidFile>(ok && data_ != 0, "Empty or not a binary file of values: " + name);
+    }
+
+    ~MappedFile()
+      { release(); }
+
+    inline const T& operator[](std::size_t i) const
+      { return(data_[i]); }
+
+    std::size_t size() const
+      { return(size_); }
+
+    bool empty() const
+      { return(size_ == 0); }
+
+    const T* data() const
+      { return(data_); }
+
+    const_iterator begin() const
+      { return(data_); }
+
+    const_iterator end() const
+      { return(data_ + size_); }
+
+  private:
+    MappedFile(const MappedFile&); // not copyable
+    MappedFile& operator=(const MappedFile&);
+
+    void map(int fd, std::size_t bytes) {
+#ifdef __linux__
+      void* mem = ::mmap(0, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if ( mem == MAP_FAILED )
+        return;
+      ::madvise(mem, bytes, MADV_SEQUENTIAL);
+#else
+      void* mem = std::malloc(bytes);
+      if ( !mem )
+        return;
+      std::size_t got = 0;
+      while ( got < bytes ) {
+        const ssize_t n = ::read(fd, static_cast<char*>(mem) + got, bytes - got);
+        if ( n <= 0 ) {
+          std::free(mem);
+          return;
+        }
+        got += static_cast<std::size_t>(n);
+      } // while
+#endif
+      data_ = static_cast<const T*>(mem);
+      bytes_ = bytes;
+      size_ = bytes / sizeof(T);
+    }
+
+    void release() {
+      if ( !data_ )
+        return;
+#ifdef __linux__
+      ::munmap(const_cast<T*>(data_), bytes_);
+#else
+      std::free(const_cast<T*>(data_));
+#endif
+      data_ = 0;
+      size_ = bytes_ = 0;
+    }
+
+  private:
+    const T* data_;
+    std::size_t size_, bytes_;
+  };
+
+} // namespace Ext
+
+#endif // MAPPED_FILE_HPP
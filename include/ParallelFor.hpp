@@ -0,0 +1,158 @@
+/*
+  FILE: ParallelFor.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 18:02:44 PDT 2026
+*/
+
+//
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph and Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ext
+{
+
+  //==============================================================================
+  // parallelFor()
+  //  Calls fn(order[k]) for every k on up to 'threads' threads, including the
+  //  caller's.  Threads take the next index from a shared counter, so putting
+  //  the biggest jobs first in 'order' keeps one late big job from holding up
+  //  the end.  The first exception thrown by fn stops the hand-out of further
+  //  jobs and is rethrown here once every thread is done.
+  //==============================================================================
+  template <typename Fn>
+  void parallelFor(const std::vector<std::size_t>& order, std::size_t threads, Fn& fn) {
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex mtx;
+
+    struct Worker {
+      static void run(const std::vector<std::size_t>& order, Fn& fn, std::atomic<std::size_t>& next,
+                      std::atomic<bool>& failed, std::exception_ptr& error, std::mutex& mtx) {
+        std::size_t k = 0;
+        while ( !failed && (k = next++) < order.size() ) {
+          try {
+            fn(order[k]);
+          } catch(...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if ( !failed )
+              error = std::current_exception(), failed = true;
+          }
+        } // while
+      }
+    };
+
+    if ( threads > order.size() )
+      threads = order.size();
+    std::vector<std::thread> pool;
+    for ( std::size_t i = 1; i < threads; ++i )
+      pool.push_back(std::thread(&Worker::run, std::cref(order), std::ref(fn), std::ref(next),
+                                 std::ref(failed), std::ref(error), std::ref(mtx)));
+    Worker::run(order, fn, next, failed, error, mtx);
+    for ( std::size_t i = 0; i < pool.size(); ++i )
+      pool[i].join();
+    if ( error )
+      std::rethrow_exception(error);
+  }
+
+  //==============================================================================
+  // stealingFor()
+  //  Calls fn(order[k], w) for every k, where w < threads names the worker
+  //  making the call, so fn may keep per-worker state (a workspace) indexed
+  //  by w.  Jobs are dealt round-robin from 'order' onto one queue per
+  //  worker.  A worker takes from the front of its own queue and, once that
+  //  is empty, steals from the back of another's, so with the biggest jobs
+  //  first in 'order' each worker starts on a big one and thieves pick up
+  //  the small leftovers.  Exceptions are handled as in parallelFor().
+  //==============================================================================
+  template <typename Fn>
+  void stealingFor(const std::vector<std::size_t>& order, std::size_t threads, Fn& fn) {
+    if ( threads > order.size() )
+      threads = order.size();
+    if ( threads == 0 )
+      return;
+
+    struct Queue {
+      std::mutex mtx_;
+      std::deque<std::size_t> jobs_;
+    };
+    std::vector<Queue> queues(threads);
+    for ( std::size_t k = 0; k < order.size(); ++k )
+      queues[k % threads].jobs_.push_back(order[k]);
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex mtx;
+
+    struct Worker {
+      static bool next(std::vector<Queue>& queues, std::size_t w, std::size_t& job) {
+        for ( std::size_t i = 0; i < queues.size(); ++i ) {
+          Queue& q = queues[(w + i) % queues.size()];
+          std::lock_guard<std::mutex> lock(q.mtx_);
+          if ( q.jobs_.empty() )
+            continue;
+          if ( i == 0 ) // our own
+            job = q.jobs_.front(), q.jobs_.pop_front();
+          else
+            job = q.jobs_.back(), q.jobs_.pop_back();
+          return(true);
+        } // for
+        return(false); // nothing is ever added, so every queue stays empty
+      }
+
+      static void run(std::vector<Queue>& queues, std::size_t w, Fn& fn, std::atomic<bool>& failed,
+                      std::exception_ptr& error, std::mutex& mtx) {
+        std::size_t job = 0;
+        while ( !failed && next(queues, w, job) ) {
+          try {
+            fn(job, w);
+          } catch(...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if ( !failed )
+              error = std::current_exception(), failed = true;
+          }
+        } // while
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for ( std::size_t w = 1; w < threads; ++w )
+      pool.push_back(std::thread(&Worker::run, std::ref(queues), w, std::ref(fn), std::ref(failed),
+                                 std::ref(error), std::ref(mtx)));
+    Worker::run(queues, 0, fn, failed, error, mtx);
+    for ( std::size_t i = 0; i < pool.size(); ++i )
+      pool[i].join();
+    if ( error )
+      std::rethrow_exception(error);
+  }
+
+} // namespace Ext
+
+#endif // PARALLEL_FOR_HPP
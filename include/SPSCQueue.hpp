@@ -0,0 +1,153 @@
+/*
+  FILE: SPSCQueue.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 09:12:40 PDT 2026
+*/
+
+//
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph and Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ext
+{
+
+  //==============================================================================
+  // SPSCQueue<T>
+  //  A bounded, single-producer/single-consumer ring buffer.  Exactly one
+  //  thread may Push() and exactly one (other) thread may Pop().  Push()
+  //  waits while the ring is full, which gives natural backpressure between
+  //  pipeline stages and keeps the number of items in flight bounded.
+  //  TryPush() and TryPop() are lock-free.  Push() and Pop() are built on
+  //  them, but a side that must wait spins briefly and then blocks on a mutex
+  //  and condition variable until the other side makes progress, so an idle
+  //  stage costs no CPU however many queues exist.  While a side is blocked,
+  //  the other takes the mutex to wake it.
+  //==============================================================================
+  template <typename T>
+  class SPSCQueue {
+  public:
+    explicit SPSCQueue(std::size_t capacity)
+      : ring_(roundUp(capacity)), mask_(ring_.size() - 1), head_(0), tail_(0), waiters_(0)
+      { /* */ }
+
+    bool TryPush(const T& t) {
+      const std::size_t tail = tail_.load(std::memory_order_relaxed);
+      if ( tail - head_.load(std::memory_order_acquire) == ring_.size() )
+        return(false); // full
+      ring_[tail & mask_] = t;
+      tail_.store(tail + 1, std::memory_order_release);
+      return(true);
+    }
+
+    bool TryPop(T& t) {
+      const std::size_t head = head_.load(std::memory_order_relaxed);
+      if ( head == tail_.load(std::memory_order_acquire) )
+        return(false); // empty
+      t = ring_[head & mask_];
+      head_.store(head + 1, std::memory_order_release);
+      return(true);
+    }
+
+    void Push(const T& t) {
+      for ( std::size_t tries = 0; !TryPush(t); ++tries )
+        backoff(tries, &SPSCQueue::notFull);
+      wake();
+    }
+
+    void Pop(T& t) {
+      for ( std::size_t tries = 0; !TryPop(t); ++tries )
+        backoff(tries, &SPSCQueue::notEmpty);
+      wake();
+    }
+
+    std::size_t Capacity() const
+      { return(ring_.size()); }
+
+  private:
+    SPSCQueue(const SPSCQueue&); // not copyable
+    SPSCQueue& operator=(const SPSCQueue&);
+
+    static std::size_t roundUp(std::size_t sz) {
+      std::size_t cap = 2;
+      while ( cap < sz )
+        cap <<= 1;
+      return(cap);
+    }
+
+    bool notFull() const
+      { return(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire) != ring_.size()); }
+
+    bool notEmpty() const
+      { return(head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_acquire)); }
+
+    void backoff(std::size_t tries, bool (SPSCQueue::*ready)() const) {
+      // spin briefly, then yield, then block until the other side moves
+      if ( tries < 64 )
+        return;
+      else if ( tries < 256 ) {
+        std::this_thread::yield();
+        return;
+      }
+      waiters_.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with wake()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while ( !(this->*ready)() )
+          cond_.wait(lock);
+      }
+      waiters_.fetch_sub(1);
+    }
+
+    void wake() {
+      // cheap when nobody sleeps ; the lock closes the window between a
+      //  waiter's final check and its wait()
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if ( waiters_.load(std::memory_order_relaxed) == 0 )
+        return;
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      cond_.notify_all();
+    }
+
+  private:
+    // padding keeps the two indices on separate cache lines without
+    //  requiring over-aligned allocation of the queue itself
+    std::vector<T> ring_;
+    const std::size_t mask_;
+    char pad0_[64];
+    std::atomic<std::size_t> head_; // owned by consumer
+    char pad1_[64];
+    std::atomic<std::size_t> tail_; // owned by producer
+    char pad2_[64];
+    std::atomic<int> waiters_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+  };
+
+} // namespace Ext
+
+#endif // SPSC_QUEUE_HPP
@@ -22,11 +22,14 @@
 //    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <string>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "Assertion.hpp"
 #include "Exception.hpp"
@@ -34,6 +37,7 @@
 #include "Wavelet.hpp"
 #include "WTBoundaries.hpp"
 #include "WTFilter.hpp"
+#include "WTHaar.hpp"
 #include "WTOps.hpp"
 
 
@@ -92,19 +96,21 @@ namespace WT {
     // modwt_forward : Overload 2
     //===============
     // o passed in Vj stores results -> scaling coefficients
-    // o passed in Wj stores results -> wavelet coefficients
+    // o passed in Wj stores results -> wavelet coefficients ; it may be any
+    //    indexable type, such as a pointer into a larger contiguous buffer
     // o this can lead to overall advantages in terms of memory savings by
     //    allowing the caller to manage these resources
     //===============
     template <
               typename Container,
+              typename WContainer,
               typename WaveletFilter,
               typename ScalingFilter,
               typename VOp,
               typename WOp
              >
     void modwt_forward(const Container& Vi, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
-                       int j, Container& Vj, Container& Wj, VOp& vop, WOp& wop) {
+                       int j, Container& Vj, WContainer& Wj, VOp& vop, WOp& wop) {
 
       const std::size_t N = static_cast<std::size_t>(Vi.size()); // Vi.size() == sequence-size
       const std::size_t L = static_cast<std::size_t>(wavefilt.size()); // wavefilt.size() == scalefilt.size()
@@ -130,6 +136,54 @@ namespace WT {
     }
 
 
+    //=========================
+    // modwt_forward_scaling() : modwt_forward() for the scaling coefficients alone
+    //=========================
+    // o used for levels whose wavelet coefficients nobody asked for ; Vj is
+    //    formed exactly as above
+    //=========================
+    template <
+              typename Container,
+              typename ScalingFilter,
+              typename VOp
+             >
+    void modwt_forward_scaling(const Container& Vi, const ScalingFilter& scalefilt, int j,
+                               Container& Vj, VOp& vop) {
+
+      const std::size_t N = static_cast<std::size_t>(Vi.size()); // Vi.size() == sequence-size
+      const std::size_t L = static_cast<std::size_t>(scalefilt.size());
+      const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j)); // assumed <= N ; asserted by caller
+      std::size_t k = 0;
+
+      for ( std::size_t t = 0; t < N; k = static_cast<std::size_t>(++t) ) {
+        Vj[t] = scalefilt[0] * Vi[t];
+
+        for ( std::size_t l = 1; l < L; ++l ) {
+          if ( k >= D )
+            k -= D;
+          else
+            k = static_cast<std::size_t>(N + k - D);
+          Vj[t] += scalefilt[l] * Vi[k];
+        } // for
+
+        vop(Vj[t]);
+      } // for
+    }
+
+
+    //=============
+    // levelMask() : mask[j] is true for each j in 'levels' ; all must lie within 1..numLevels
+    //=============
+    inline std::vector<bool> levelMask(const std::vector<int>& levels, int numLevels, const char* who) {
+      std::vector<bool> mask(numLevels + 1, false);
+      for ( std::size_t i = 0; i < levels.size(); ++i ) {
+        Ext::Assert<Ext::ArgumentError>(levels[i] >= 1 && levels[i] <= numLevels, who, "level out of range");
+        mask[levels[i]] = true;
+      } // for
+      return(mask);
+    }
+
+
     //===================
     // imodwt_backward() : the workhorse of imodwt()
     //===================
@@ -137,14 +191,16 @@ namespace WT {
     // o A related function below can be used in a way to save some memory overhead
     //    when calculating smooth/details.  That one, imodwt_backward_zerophase(),
     //    works with one container of coefficients & "applies" a zero-phase filter.
+    // o Wj may be any indexable type, such as a pointer into a larger buffer
     //===================
     template <
               typename Container,
+              typename WContainer,
               typename WaveletFilter,
               typename ScalingFilter,
               typename VOp
              >
-    void imodwt_backward(const Container& Vj, const Container& Wj, const WaveletFilter& wavefilt,
+    void imodwt_backward(const Container& Vj, const WContainer& Wj, const WaveletFilter& wavefilt,
                          const ScalingFilter& scalefilt, int j, Container& Vi, VOp& vop) {
 
       const std::size_t N = static_cast<std::size_t>(Vj.size()); // Vj.size() == sequence-size
@@ -260,6 +316,238 @@ namespace WT {
       } // for
     }
 
+
+    //=====================
+    // haar_modwt_levels() : modwt_levels() for the Haar filter
+    //=====================
+    // o like haar_modwt(), but Wavelet() is only evaluated at the chosen levels
+    //=====================
+    template <
+              typename Sequence,
+              typename VOp,
+              typename WOp
+             >
+    void haar_modwt_levels(const Sequence& X, int numLevels, const std::vector<bool>& want, VOp& vop, WOp& wop) {
+      typedef typename Sequence::value_type T;
+      typedef typename Haar::ResultFor<T>::type R;
+
+      Haar::PrefixEngine<typename Haar::AccumFor<T>::type> engine(X);
+      const std::size_t N = engine.size();
+      for ( int j = 1; j <= numLevels; ++j ) {
+        vop.Level(j);
+        if ( want[j] ) {
+          wop.Level(j);
+          for ( std::size_t t = 0; t < N; ++t ) {
+            vop(static_cast<R>(engine.Scaling(j, t)));
+            wop(static_cast<R>(engine.Wavelet(j, t)));
+          } // for
+        }
+        else {
+          for ( std::size_t t = 0; t < N; ++t )
+            vop(static_cast<R>(engine.Scaling(j, t)));
+        }
+      } // for
+    }
+
+
+    //==============
+    // haar_doAll() : doAll() for the Haar filter
+    //==============
+    // o Wavelet and scaling coefficients of any level come straight from
+    //    prefix sums of 'X', so there is no forward cascade
+    // o 'X' is free for use as scratch once the engine is built.  Peak
+    //    memory is 'X', the engine's N+1 sums and (only for details or
+    //    the smooth) one more Sequence.
+    //==============
+    template <
+              typename Sequence,
+              typename Filts,
+              typename WaveletCoefficientOps,
+              typename DetailsOp,
+              typename ScalingCoefficientOp,
+              typename SmoothOp
+             >
+    void haar_doAll(Sequence& X,
+                    unsigned int level,
+                    const Filts& filters,
+                    WaveletCoefficientOps& waveletOp,
+                    DetailsOp& detailsOp,
+                    ScalingCoefficientOp& scalingOp,
+                    SmoothOp& smoothOp) {
+
+      typedef typename Sequence::value_type T;
+      Haar::PrefixEngine<typename Haar::AccumFor<T>::type> engine(X);
+      const std::size_t N = engine.size();
+      Sequence* zPtr = static_cast<Sequence*>(0);
+
+      bool scalingWasOn = scalingOp.IsOn();
+      scalingOp.Off(); // only the last level's scaling coefficients are given out
+
+      for ( unsigned int idx = 1; idx <= level; ++idx ) {
+        waveletOp.Level(idx);
+
+        detailsOp.Reset();
+        detailsOp.Level(idx); // level setting must come before IsOn() checks
+        if ( detailsOp.IsOn() ) {
+          if ( !zPtr )
+            zPtr = new Sequence(N);
+          Sequence& Wj = *zPtr;
+          for ( std::size_t t = 0; t < N; ++t ) {
+            Wj[t] = static_cast<T>(engine.Wavelet(idx, t));
+            waveletOp(Wj[t]);
+          } // for
+          Details::details_one(Wj, X, filters.first, filters.second, idx-1, detailsOp);
+        }
+        else {
+          for ( std::size_t t = 0; t < N; ++t )
+            waveletOp(static_cast<T>(engine.Wavelet(idx, t)));
+        }
+
+        smoothOp.Level(idx); // level setting must come before IsOn() checks
+        if ( idx == level ) {
+          bool wantSmooth = smoothOp.IsOn();
+          if ( scalingWasOn ) {
+            scalingOp.On();
+            scalingOp.Level(idx);
+          }
+          if ( scalingWasOn || wantSmooth ) {
+            for ( std::size_t t = 0; t < N; ++t ) {
+              X[t] = static_cast<T>(engine.Scaling(idx, t));
+              scalingOp(X[t]);
+            } // for
+          }
+          if ( wantSmooth ) {
+            if ( !zPtr )
+              zPtr = new Sequence(N);
+            Details::smooth_one(X, *zPtr, filters.second, idx-1, smoothOp);
+          }
+        }
+      } // for
+
+      if ( zPtr )
+        delete zPtr;
+    }
+
+    //===============
+    // dwt_forward() : one level of the DWT pyramid algorithm
+    //===============
+    // o reads V_{j-1} from Vi[0..M) and writes V_j to Vj[0..M/2) and W_j
+    //    to Vj[M/2..M) ; 'M' must be even
+    // o V_{j-1} is circularly filtered and downsampled by two
+    //===============
+    template <
+              typename Container,
+              typename WaveletFilter,
+              typename ScalingFilter,
+              typename VOp,
+              typename WOp
+             >
+    void dwt_forward(const Container& Vi, std::size_t M, const WaveletFilter& wavefilt,
+                     const ScalingFilter& scalefilt, Container& Vj, VOp& vop, WOp& wop) {
+
+      const std::size_t L = static_cast<std::size_t>(wavefilt.size()); // wavefilt.size() == scalefilt.size()
+      const std::size_t half = M / 2;
+      for ( std::size_t t = 0; t < half; ++t ) {
+        std::size_t k = 2 * t + 1;
+        Vj[t] = scalefilt[0] * Vi[k];
+        Vj[half + t] = wavefilt[0] * Vi[k];
+        for ( std::size_t l = 1; l < L; ++l ) {
+          k = (k == 0) ? M - 1 : k - 1;
+          Vj[t] += scalefilt[l] * Vi[k];
+          Vj[half + t] += wavefilt[l] * Vi[k];
+        } // for
+        vop(Vj[t]);
+        wop(Vj[half + t]);
+      } // for
+    }
+
+
+    //=================
+    // idwt_backward() : one level of the inverse DWT pyramid algorithm
+    //=================
+    // o V_j is read from Vj[vOff..vOff+M/2) and W_j from Vj[wOff..wOff+M/2).
+    //    An offset of 'npos' stands for a set of all-zero coefficients,
+    //    whose contribution is skipped rather than computed.
+    // o V_{j-1} is written to Vi[0..M)
+    //=================
+    template <
+              typename Container,
+              typename WaveletFilter,
+              typename ScalingFilter,
+              typename VOp
+             >
+    void idwt_backward(const Container& Vj, std::size_t vOff, std::size_t wOff, std::size_t M,
+                       const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                       Container& Vi, VOp& vop) {
+
+      static const std::size_t npos = static_cast<std::size_t>(-1);
+      const std::size_t L = static_cast<std::size_t>(wavefilt.size()); // wavefilt.size() == scalefilt.size()
+      const bool useV = (vOff != npos), useW = (wOff != npos);
+      for ( std::size_t t = 0; t < M; ++t ) {
+        typename Container::value_type sum = 0;
+        // only odd (t+l) hit a nonzero sample of the upsampled coefficients
+        std::size_t u = t, l = 0;
+        if ( u % 2 == 0 ) // M is even, so u+1 < M
+          ++u, l = 1;
+        for ( ; l < L; l += 2 ) {
+          const std::size_t k = (u - 1) / 2;
+          if ( useV )
+            sum += scalefilt[l] * Vj[vOff + k];
+          if ( useW )
+            sum += wavefilt[l] * Vj[wOff + k];
+          u += 2;
+          if ( u >= M )
+            u -= M;
+        } // for
+        Vi[t] = sum;
+        vop(Vi[t]);
+      } // for
+    }
+
+    //===============
+    // sweep_first() : level 1 of modwt_forward() for several filters in one pass
+    //===============
+    // o the last L values of 'X' up to t are gathered once per t into 'window'
+    //    and every filter reads them from there
+    // o V1[f] gets filter f's scaling coefficients ; sums are formed exactly
+    //    as in modwt_forward()
+    //===============
+    template <
+              typename Sequence,
+              typename Filts,
+              typename ContVOps,
+              typename ContWOps
+             >
+    void sweep_first(const Sequence& X, const std::vector<Filts>& filters, const std::vector<std::size_t>& which,
+                     std::vector<Sequence>& V1, ContVOps& vops, ContWOps& wops) {
+
+      typedef typename Sequence::value_type T;
+      const std::size_t N = static_cast<std::size_t>(X.size());
+      std::size_t L = 0;
+      for ( std::size_t f = 0; f < filters.size(); ++f )
+        L = std::max<std::size_t>(L, filters[f].first.size());
+      std::vector<T> window(L);
+
+      for ( std::size_t t = 0; t < N; ++t ) {
+        for ( std::size_t l = 0, k = t; l < L; ++l, k = (k > 0) ? k - 1 : N - 1 )
+          window[l] = X[k];
+
+        for ( std::size_t f = 0; f < filters.size(); ++f ) {
+          const typename Filts::first_type& wavefilt = filters[f].first;
+          const typename Filts::second_type& scalefilt = filters[f].second;
+          T& Vj = V1[f][t];
+          Vj = scalefilt[0] * window[0];
+          T Wj = wavefilt[0] * window[0];
+          for ( std::size_t l = 1; l < wavefilt.size(); ++l ) {
+            Vj += scalefilt[l] * window[l];
+            Wj += wavefilt[l] * window[l];
+          } // for
+          vops[which[f]](Vj);
+          wops[which[f]](Wj);
+        } // for
+      } // for
+    }
+
   } // namespace Details
 
 
@@ -293,6 +581,133 @@ namespace WT {
   }
 
 
+  //=========
+  // modwt() : Modified Discrete Wavelet Transform, given a filter type
+  //=========
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void modwt(Sequence& X, Filter::FType filterType, int numLevels, VOp& vop, WOp& wop) {
+    if ( filterType == Filter::Haar ) { // no cascade needed
+      haar_modwt(X, numLevels, vop, wop);
+      return;
+    }
+
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwt(X, filters.first, filters.second, numLevels, vop, wop);
+  }
+
+
+  //===============
+  // modwt_sweep()
+  //===============
+  template <
+            typename Sequence,
+            typename ContVOps,
+            typename ContWOps
+           >
+  void modwt_sweep(const Sequence& X, const std::vector<Filter::FType>& filterTypes, int numLevels,
+                   ContVOps& vops, ContWOps& wops) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_sweep()", "wavelet xfm exceeds sample size");
+    Ext::Assert<Ext::ArgumentError>(vops.size() == filterTypes.size() && wops.size() == filterTypes.size(),
+                                    "modwt_sweep()", "need one op per filter");
+
+    // Haar has no cascade to share ; see haar_modwt()
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    std::vector<Filts> filters;
+    std::vector<std::size_t> which;
+    for ( std::size_t f = 0; f < filterTypes.size(); ++f ) {
+      if ( filterTypes[f] == Filter::Haar )
+        haar_modwt(X, numLevels, vops[f], wops[f]);
+      else {
+        filters.push_back(WT::Filter::getFilters<WT::MODWT>(filterTypes[f]));
+        which.push_back(f);
+      }
+    } // for
+    if ( filters.empty() || numLevels < 1 )
+      return;
+
+    for ( std::size_t f = 0; f < which.size(); ++f ) {
+      vops[which[f]].Level(1);
+      wops[which[f]].Level(1);
+    } // for
+    std::vector<Sequence> V1(filters.size(), Sequence(X.size(), 0));
+    Details::sweep_first(X, filters, which, V1, vops, wops);
+
+    // levels 2 and up: one cascade per filter, sharing the scratch sequence
+    Sequence Vk(numLevels > 1 ? X.size() : 0, 0);
+    for ( std::size_t f = 0; f < filters.size(); ++f ) {
+      Sequence* Vi = &V1[f];
+      Sequence* Vj = &Vk;
+      for ( int j = 1; j < numLevels; ++j ) {
+        vops[which[f]].Level(j+1);
+        wops[which[f]].Level(j+1);
+        Details::modwt_forward(*Vi, filters[f].first, filters[f].second, j, *Vj, vops[which[f]], wops[which[f]]);
+        std::swap(Vi, Vj);
+      } // for
+    } // for
+  }
+
+
+  //================
+  // modwt_levels()
+  //================
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_levels(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+                    const std::vector<int>& levels, VOp& vop, WOp& wop) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_levels()", "wavelet xfm exceeds sample size");
+    const std::vector<bool> want = Details::levelMask(levels, numLevels, "modwt_levels()");
+
+    Sequence const *Vi = &X;
+    Sequence Vk(X.size(), 0);
+    Sequence* Vj = &Vk;
+
+    for ( int j = 0; j < numLevels; ++j ) {
+      vop.Level(j+1);
+      if ( want[j+1] ) {
+        wop.Level(j+1);
+        Details::modwt_forward(*Vi, wavefilt, scalefilt, j, *Vj, vop, wop);
+      }
+      else
+        Details::modwt_forward_scaling(*Vi, scalefilt, j, *Vj, vop);
+      Vi = Vj;
+      Vj = (Vi == &Vk) ? &X : &Vk;
+    } // for
+  }
+
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_levels(Sequence& X, Filter::FType filterType, int numLevels,
+                    const std::vector<int>& levels, VOp& vop, WOp& wop) {
+    if ( filterType == Filter::Haar ) { // no cascade needed
+      double expsz = numLevels - 1;
+      Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_levels()", "wavelet xfm exceeds sample size");
+      Details::haar_modwt_levels(X, numLevels, Details::levelMask(levels, numLevels, "modwt_levels()"), vop, wop);
+      return;
+    }
+
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwt_levels(X, filters.first, filters.second, numLevels, levels, vop, wop);
+  }
+
+
   //==========
   // imodwt() : Inverse Modified Discrete Wavelet Transform
   //==========
@@ -325,6 +740,74 @@ namespace WT {
   }
 
 
+  //=================
+  // imodwt_sparse()
+  //=================
+  template <
+            typename SparseEntries,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp
+           >
+  void imodwt_sparse(const SparseEntries& Vj0, const SparseEntries& Wj, std::size_t N, int numLevels,
+                     const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, VOp& vop) {
+
+    typedef typename SparseEntries::value_type::value_type T;
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(N > 0 && N >= std::pow(2.0, expsz), "imodwt_sparse()", "wavelet xfm exceeds sample size");
+
+    // group the wavelet terms by level ; the cascade starts at the deepest one (or V_J)
+    std::vector< std::vector<std::size_t> > byLevel(numLevels + 1);
+    int top = Vj0.empty() ? 0 : numLevels;
+    for ( std::size_t i = 0; i < Wj.size(); ++i ) {
+      const int j = Wj[i].level_;
+      Ext::Assert<Ext::ArgumentError>(j >= 1 && j <= numLevels && Wj[i].index_ < N, "imodwt_sparse()", "coefficient out of range");
+      byLevel[j].push_back(i);
+      top = std::max(top, j);
+    } // for
+
+    std::vector<T> V(N, 0), Vn(N, 0);
+    for ( std::size_t i = 0; i < Vj0.size(); ++i ) {
+      Ext::Assert<Ext::ArgumentError>(Vj0[i].level_ == numLevels && Vj0[i].index_ < N, "imodwt_sparse()", "coefficient out of range");
+      V[Vj0[i].index_] = Vj0[i].value_;
+    } // for
+
+    if ( top == 0 ) { // nothing listed -> all zeros
+      vop.Level(0);
+      for ( std::size_t t = 0; t < N; ++t )
+        vop(V[t]);
+      return;
+    }
+
+    const std::size_t L = static_cast<std::size_t>(wavefilt.size());
+    bool haveV = !Vj0.empty();
+    DoNothing none;
+    for ( int j = top - 1; j >= 0; --j ) {
+      vop.Level(j);
+      if ( haveV )
+        Details::imodwt_backward_zerophase(V, scalefilt, j, Vn, none);
+      else
+        std::fill(Vn.begin(), Vn.end(), T(0));
+
+      // W_{j+1}[k] reaches V_j[t] for t = k - l*2^j, l = 0..L-1 (periodic)
+      const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j)); // <= N ; asserted above
+      for ( std::size_t i = 0; i < byLevel[j+1].size(); ++i ) {
+        const typename SparseEntries::value_type& e = Wj[byLevel[j+1][i]];
+        std::size_t t = e.index_;
+        for ( std::size_t l = 0; l < L; ++l ) {
+          Vn[t] += wavefilt[l] * e.value_;
+          t = (t >= D) ? t - D : t + N - D;
+        } // for
+      } // for
+
+      for ( std::size_t t = 0; t < N; ++t )
+        vop(Vn[t]);
+      V.swap(Vn);
+      haveV = true;
+    } // for
+  }
+
+
   //==========
   // smooth() : calculates the smooth from the scaling coefficients
   //==========
@@ -382,6 +865,33 @@ namespace WT {
   }
 
 
+  //==================
+  // details_levels()
+  //==================
+  template <
+            typename ContWaveletCoefficients,
+            typename WaveletFilter,
+            typename ScaleFilter,
+            typename ContDetailsOps
+           >
+  void details_levels(ContWaveletCoefficients& Wj, const std::vector<int>& levels, const WaveletFilter& wavefilt,
+                      const ScaleFilter& scalefilt, ContDetailsOps& dops) {
+
+    if ( Wj.empty() )
+      return;
+
+    typedef typename ContWaveletCoefficients::value_type VT;
+    Ext::Assert<Ext::ArgumentError>(Wj.size() == levels.size(), "details_levels()", "need one level per coefficient set");
+    VT Wit(Wj.begin()->size());
+    for ( std::size_t i = 0; i < Wj.size(); ++i ) {
+      double expsz = levels[i] - 1;
+      Ext::Assert<Ext::ArgumentError>(levels[i] >= 1 && Wj[i].size() >= std::pow(2.0, expsz),
+                                      "details_levels()", "wavelet xfm exceeds sample size");
+      Details::details_one(Wj[i], Wit, wavefilt, scalefilt, levels[i] - 1, dops[i]);
+    } // for
+  }
+
+
   //=========
   // doAll() : calculates everything from scratch ('X') giving opportunities for all output
   //=========
@@ -404,14 +914,19 @@ namespace WT {
     double expsz = level - 1;
     Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "doAll()", "wavelet xfm exceeds sample size");
 
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+
+    if ( filterType == Filter::Haar ) { // prefix sums rather than a cascade
+      Details::haar_doAll(X, level, filters, waveletOp, detailsOp, scalingOp, smoothOp);
+      return;
+    }
+
     Sequence Y(X.size());
     Sequence* xPtr = &X;
     Sequence* yPtr = &Y;
     Sequence* zPtr = static_cast<Sequence*>(0);
 
-    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
-    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
-
     bool scalingWasOn = scalingOp.IsOn();
     scalingOp.Off(); // need off during modwt call except on last level
 
@@ -482,6 +997,241 @@ namespace WT {
   }
 
 
+  namespace Details {
+
+    //===================
+    // SmoothsAccumulator : details op for smooths() ; self-regulates like PrintLast
+    //===================
+    // o only the final pass of each details_one() cascade is D_j ; every value of it
+    //    is taken off the accumulator, which then holds S_j and is passed on
+    //===================
+    template <typename Accumulator, typename SmoothOp>
+    struct SmoothsAccumulator {
+      SmoothsAccumulator(Accumulator& acc, SmoothOp& sop)
+        : acc_(acc), sop_(sop), last_(0), level_(0), t_(0)
+        { /* */ }
+
+      void Reset() { ++last_; }
+      void Level(int level) { level_ = level, t_ = 0; }
+      bool IsOn() { return(true); }
+
+      template <typename T>
+      inline void operator()(const T& d) {
+        if ( level_ != last_ )
+          return;
+        if ( t_ == 0 )
+          sop_.Level(level_);
+        acc_[t_] -= d;
+        sop_(static_cast<T>(acc_[t_]));
+        ++t_;
+      }
+
+    private:
+      Accumulator& acc_;
+      SmoothOp& sop_;
+      int last_, level_;
+      std::size_t t_;
+    };
+
+  } // namespace Details
+
+
+  //===========
+  // smooths()
+  //===========
+  template <
+            typename Sequence,
+            typename SmoothOp
+           >
+  void smooths(Sequence& X, unsigned int level, Filter::FType filterType, SmoothOp& sop) {
+
+    Ext::Assert<Ext::ArgumentError>(!X.empty(), "smooths()", "empty input");
+
+    // double keeps the level-by-level sums from drifting with float input
+    std::vector<double> acc(X.begin(), X.end());
+    Details::SmoothsAccumulator<std::vector<double>, SmoothOp> dop(acc, sop);
+    DoNothing waveletOp, scalingOp, smoothOp;
+    doAll(X, level, filterType, waveletOp, dop, scalingOp, smoothOp);
+  }
+
+
+  //============
+  // bandpass()
+  //============
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename Op
+           >
+  void bandpass(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+                const std::vector<int>& levels, bool withSmooth, Op& op) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "bandpass()", "wavelet xfm exceeds sample size");
+    Ext::Assert<Ext::ArgumentError>(withSmooth || !levels.empty(), "bandpass()", "nothing in the band");
+
+    // W_j is kept only for the wanted levels ; the forward cascade stops at the deepest one needed
+    std::vector<int> slot(numLevels + 1, -1);
+    int top = withSmooth ? numLevels : 0, kept = 0;
+    for ( std::size_t i = 0; i < levels.size(); ++i ) {
+      const int j = levels[i];
+      Ext::Assert<Ext::ArgumentError>(j >= 1 && j <= numLevels, "bandpass()", "level out of range");
+      if ( slot[j] < 0 )
+        slot[j] = kept++;
+      top = std::max(top, j);
+    } // for
+
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    std::vector<Sequence> W(kept, Sequence(N, 0));
+    Sequence Vk(N, 0);
+    Sequence* Vi = &X;
+    Sequence* Vj = &Vk;
+    DoNothing none;
+    for ( int j = 0; j < top; ++j ) {
+      if ( slot[j+1] >= 0 )
+        Details::modwt_forward(*Vi, wavefilt, scalefilt, j, *Vj, W[slot[j+1]], none, none);
+      else
+        Details::modwt_forward(*Vi, wavefilt, scalefilt, j, *Vj, none, none);
+      std::swap(Vi, Vj);
+    } // for
+
+    // *Vi is V_top ; it only counts toward the band with the smooth
+    bool haveV = withSmooth;
+    for ( int j = top - 1; j >= 0; --j ) {
+      op.Level(numLevels - j); // counting backwards
+      if ( haveV && slot[j+1] >= 0 )
+        Details::imodwt_backward(*Vi, W[slot[j+1]], wavefilt, scalefilt, j, *Vj, op);
+      else if ( haveV )
+        Details::imodwt_backward_zerophase(*Vi, scalefilt, j, *Vj, op);
+      else // the deepest wanted detail starts the cascade
+        Details::imodwt_backward_zerophase(W[slot[j+1]], wavefilt, j, *Vj, op);
+      haveV = true;
+      std::swap(Vi, Vj);
+    } // for
+  }
+
+  template <typename Sequence, typename Op>
+  void bandpass(Sequence& X, Filter::FType filterType, int numLevels,
+                const std::vector<int>& levels, bool withSmooth, Op& op) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    bandpass(X, filters.first, filters.second, numLevels, levels, withSmooth, op);
+  }
+
+
+  //=======
+  // dwt() : Discrete Wavelet Transform via the pyramid algorithm
+  //=======
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp,
+            typename WOp
+           >
+  void dwt(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+           VOp& vop, WOp& wop) {
+
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    const std::size_t D = static_cast<std::size_t>(std::pow(2.0, numLevels));
+    Ext::Assert<Ext::ArgumentError>(numLevels > 0 && N >= D && N % D == 0, "dwt()",
+                                    "sample size must be a multiple of 2^level");
+
+    // X holds [V_{j-1} | W_{j-1} .. W_1] going into level j.  V_{j-1} is
+    //  split into V_j and W_j in 'S', then copied back over itself.
+    Sequence S(N, 0); // one N-sized scratch ; 2N in all
+    std::size_t M = N;
+    for ( int j = 1; j <= numLevels; ++j, M /= 2 ) {
+      vop.Level(j);
+      wop.Level(j);
+      Details::dwt_forward(X, M, wavefilt, scalefilt, S, vop, wop);
+      for ( std::size_t t = 0; t < M; ++t )
+        X[t] = S[t];
+    } // for
+  }
+
+
+  //========
+  // idwt() : inverse of dwt() ; X must be in the layout dwt() leaves behind
+  //========
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp
+           >
+  void idwt(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+            VOp& vop) {
+
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    const std::size_t D = static_cast<std::size_t>(std::pow(2.0, numLevels));
+    Ext::Assert<Ext::ArgumentError>(numLevels > 0 && N >= D && N % D == 0, "idwt()",
+                                    "sample size must be a multiple of 2^level");
+
+    Sequence S(N, 0);
+    std::size_t M = N / D * 2; // length of V_{j-1}
+    for ( int j = numLevels; j >= 1; --j, M *= 2 ) {
+      vop.Level(j - 1);
+      Details::idwt_backward(X, 0, M / 2, M, wavefilt, scalefilt, S, vop);
+      for ( std::size_t t = 0; t < M; ++t )
+        X[t] = S[t];
+    } // for
+  }
+
+
+  //===========
+  // dwt_mra() : DWT-based multiresolution analysis ; details and smooth
+  //===========
+  template <
+            typename Sequence,
+            typename DetailsOp,
+            typename SmoothOp
+           >
+  void dwt_mra(Sequence& X,
+               unsigned int level,
+               Filter::FType filterType,
+               DetailsOp& detailsOp,
+               SmoothOp& smoothOp) {
+
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::DWT>(filterType);
+    DoNothing nothing;
+    dwt(X, filters.first, filters.second, static_cast<int>(level), nothing, nothing);
+
+    // Each detail (and the smooth) is the inverse of a single coefficient set.
+    //  Every other set is zero, so only one filter applies per step.
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    Sequence A(N, 0), B(N / 2, 0);
+    for ( unsigned int j = 1; j <= level; ++j ) {
+      detailsOp.Level(j);
+      smoothOp.Level(j);
+      const bool wantSmooth = (j == level && smoothOp.IsOn());
+      for ( int which = 0; which < (wantSmooth ? 2 : 1); ++which ) {
+        const bool isSmooth = (which == 1);
+        std::size_t M = N >> (j - 1); // length of V_{j-1}
+        Sequence* in = &X;
+        Sequence* out = (j % 2) ? &A : &B; // lands in A when M == N
+        std::size_t vOff = isSmooth ? 0 : npos, wOff = isSmooth ? npos : M / 2;
+        for ( unsigned int k = j; k >= 1; --k, M *= 2 ) {
+          if ( k == 1 ) {
+            if ( isSmooth )
+              Details::idwt_backward(*in, vOff, wOff, M, filters.first, filters.second, *out, smoothOp);
+            else
+              Details::idwt_backward(*in, vOff, wOff, M, filters.first, filters.second, *out, detailsOp);
+          }
+          else
+            Details::idwt_backward(*in, vOff, wOff, M, filters.first, filters.second, *out, nothing);
+          in = out;
+          out = (out == &A) ? &B : &A;
+          vOff = 0, wOff = npos;
+        } // for
+      } // for
+    } // for
+  }
+
+
   //==================
   // selectBoundary()
   //==================
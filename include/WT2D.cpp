@@ -0,0 +1,385 @@
+/*
+  FILE: WT2D.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 15:20:48 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WT2D.hpp"
+
+
+namespace WT {
+
+  std::string subbandName(Subband band) {
+    static const char* names[] = { "LL", "LH", "HL", "HH" };
+    return(names[band]);
+  }
+
+
+  //==========
+  // RowStore
+  //==========
+
+  template <typename T>
+  RowStore<T>::RowStore(std::size_t cols, bool onDisk) : rows_(0), cols_(cols), file_(0) {
+    if ( onDisk ) {
+      file_ = std::tmpfile();
+      Ext::Assert<Ext::InvalidFile>(file_ != 0, "Unable to create a temporary file for a RowStore");
+    }
+  }
+
+  template <typename T>
+  RowStore<T>::RowStore(std::size_t rows, std::size_t cols, bool onDisk) : rows_(0), cols_(cols), file_(0) {
+    if ( onDisk ) {
+      file_ = std::tmpfile();
+      Ext::Assert<Ext::InvalidFile>(file_ != 0, "Unable to create a temporary file for a RowStore");
+      Ext::Assert<Ext::InvalidFile>(0 == ::ftruncate(fileno(file_), static_cast<off_t>(rows * cols * sizeof(T))),
+                                    "Unable to size a temporary file for a RowStore");
+    }
+    else
+      mem_.resize(rows * cols, T(0));
+    rows_ = rows;
+  }
+
+  template <typename T>
+  RowStore<T>::~RowStore() {
+    if ( file_ )
+      std::fclose(file_); // tmpfile() removes itself
+  }
+
+  template <typename T>
+  void RowStore<T>::Append(const T* row) {
+    if ( file_ )
+      io(true, rows_, 1, const_cast<T*>(row));
+    else
+      mem_.insert(mem_.end(), row, row + cols_);
+    ++rows_;
+  }
+
+  template <typename T>
+  void RowStore<T>::GetRows(long long first, std::size_t n, T* out) const {
+    // in runs of rows that do not wrap
+    const long long R = static_cast<long long>(rows_);
+    while ( n > 0 ) {
+      std::size_t r = static_cast<std::size_t>(((first % R) + R) % R);
+      std::size_t run = std::min(n, rows_ - r);
+      io(false, r, run, out);
+      out += run * cols_, first += static_cast<long long>(run), n -= run;
+    } // while
+  }
+
+  template <typename T>
+  void RowStore<T>::PutRows(std::size_t first, std::size_t n, const T* in) {
+    Ext::Assert<Ext::ArgumentError>(first + n <= rows_, "RowStore::PutRows()", "rows out of range");
+    io(true, first, n, const_cast<T*>(in));
+  }
+
+  template <typename T>
+  void RowStore<T>::io(bool write, std::size_t first, std::size_t n, T* buf) const {
+    if ( !file_ ) {
+      T* mem = const_cast<T*>(&mem_[0]) + first * cols_;
+      if ( write )
+        std::copy(buf, buf + n * cols_, mem);
+      else
+        std::copy(mem, mem + n * cols_, buf);
+      return;
+    }
+
+    char* bytes = reinterpret_cast<char*>(buf);
+    std::size_t sz = n * cols_ * sizeof(T);
+    off_t offset = static_cast<off_t>(first * cols_ * sizeof(T));
+    const int fd = fileno(file_);
+    while ( sz > 0 ) {
+      ssize_t done = write ? ::pwrite(fd, bytes, sz, offset) : ::pread(fd, bytes, sz, offset);
+      Ext::Assert<Ext::InvalidFile>(done > 0, "RowStore: temporary file I/O failed");
+      bytes += done, sz -= static_cast<std::size_t>(done), offset += done;
+    } // while
+  }
+
+
+  //============
+  // PrintBands
+  //============
+
+  PrintBands::PrintBands(const std::string& detailsBase, const std::string& llBase, int llLevel,
+                         std::size_t outRows, std::size_t outCols)
+      : levels_(4, 0), use_(4, false), outRows_(outRows), outCols_(outCols) {
+
+    for ( int b = LL; b <= HH; ++b ) {
+      const std::string& base = (b == LL) ? llBase : detailsBase;
+      use_[b] = !base.empty();
+      if ( b == LL )
+        bands_.push_back(PrintValues(base.empty() ? "unused" : base,
+                                     std::numeric_limits<std::size_t>::max(), llLevel));
+      else
+        bands_.push_back(PrintValues(base.empty() ? "unused" : base + "-" + subbandName(Subband(b))));
+    } // for
+  }
+
+  template <typename T>
+  void PrintBands::Block(int level, Subband band, std::size_t firstRow, std::size_t numRows,
+                         std::size_t numCols, const T* values) {
+    if ( !use_[band] )
+      return;
+    PrintValues& out = bands_[band];
+    if ( levels_[band] != level ) // first block of a new level
+      out.Level(level), levels_[band] = level;
+    if ( !out.IsOn() )
+      return;
+
+    const std::size_t cols = std::min(numCols, outCols_);
+    for ( std::size_t r = 0; r < numRows && firstRow + r < outRows_; ++r ) {
+      const T* row = values + r * numCols;
+      for ( std::size_t c = 0; c < cols; ++c )
+        out(row[c]);
+    } // for
+  }
+
+
+  namespace Details {
+
+    //======
+    // Span : a run of contiguous T's posing as a Container for the 1D kernels
+    //======
+    template <typename T>
+    struct Span {
+      typedef T value_type;
+      Span(T* p, std::size_t n) : p_(p), n_(n)
+        { /* */ }
+      std::size_t size() const { return(n_); }
+      T& operator[](std::size_t i) const { return(p_[i]); }
+
+    private:
+      T* p_;
+      std::size_t n_;
+    };
+
+    //===================
+    // transpose_tiled() : out = transpose of in, one cache-sized tile at a time
+    //===================
+    // o 'in' is rows x cols with a row stride of inStride
+    // o 'out' is cols x rows with a row stride of outStride
+    //===================
+    template <typename T>
+    void transpose_tiled(const T* in, std::size_t rows, std::size_t cols, std::size_t inStride,
+                         T* out, std::size_t outStride) {
+      static const std::size_t Tile = 32; // 2 tiles of floats or doubles fit well within L1
+      for ( std::size_t r0 = 0; r0 < rows; r0 += Tile ) {
+        const std::size_t rEnd = std::min(r0 + Tile, rows);
+        for ( std::size_t c0 = 0; c0 < cols; c0 += Tile ) {
+          const std::size_t cEnd = std::min(c0 + Tile, cols);
+          for ( std::size_t r = r0; r < rEnd; ++r ) {
+            for ( std::size_t c = c0; c < cEnd; ++c )
+              out[c * outStride + r] = in[r * inStride + c];
+          } // for
+        } // for
+      } // for
+    }
+
+    //===============
+    // filter_runs() : modwt_forward() over each of 'count' runs of 'len' values
+    //===============
+    template <typename T, typename WaveletFilter, typename ScalingFilter>
+    void filter_runs(T* in, std::size_t count, std::size_t len, const WaveletFilter& wavefilt,
+                     const ScalingFilter& scalefilt, int j, T* lo, T* hi) {
+      DoNothing nothing;
+      for ( std::size_t i = 0; i < count; ++i ) {
+        Span<T> x(in + i * len, len), v(lo + i * len, len), w(hi + i * len, len);
+        modwt_forward(x, wavefilt, scalefilt, j, v, w, nothing, nothing);
+      } // for
+    }
+
+    //=================
+    // zerophase_2d() : imodwt_backward_zerophase() along rows, then along columns
+    //=================
+    // o M (rows x cols) is replaced by the result ; S is scratch of the same size
+    //=================
+    template <typename T, typename RowFilter, typename ColFilter>
+    void zerophase_2d(std::vector<T>& M, std::vector<T>& S, std::size_t rows, std::size_t cols,
+                      const RowFilter& rowfilt, const ColFilter& colfilt, int j) {
+      DoNothing nothing;
+      for ( std::size_t r = 0; r < rows; ++r ) {
+        Span<T> in(&M[r * cols], cols), out(&S[r * cols], cols);
+        imodwt_backward_zerophase(in, rowfilt, j, out, nothing);
+      } // for
+      transpose_tiled(&S[0], rows, cols, cols, &M[0], rows);
+      for ( std::size_t c = 0; c < cols; ++c ) {
+        Span<T> in(&M[c * rows], rows), out(&S[c * rows], rows);
+        imodwt_backward_zerophase(in, colfilt, j, out, nothing);
+      } // for
+      transpose_tiled(&S[0], cols, rows, rows, &M[0], cols);
+    }
+
+    //===========
+    // MRA2DSink : turns whole-matrix subbands from modwt2d() into details and the smooth
+    //===========
+    template <typename T, typename Filts, typename BlockSink>
+    struct MRA2DSink {
+      MRA2DSink(const Filts& filters, int numLevels, BlockSink& sink)
+        : filters_(filters), numLevels_(numLevels), sink_(sink)
+        { /* */ }
+
+      void Block(int level, Subband band, std::size_t firstRow, std::size_t numRows,
+                 std::size_t numCols, const T* values) {
+        if ( band == LL && level != numLevels_ )
+          return;
+
+        // Like details_one() and smooth_one(): the subband's own filters at its
+        //  level, then the scaling filter in both directions down to level 1
+        M_.assign(values, values + numRows * numCols);
+        S_.resize(M_.size());
+        for ( int j = level - 1; j >= 0; --j ) {
+          const bool top = (j == level - 1);
+          const bool rowWave = top && (band == HL || band == HH);
+          const bool colWave = top && (band == LH || band == HH);
+          if ( rowWave && colWave )
+            zerophase_2d(M_, S_, numRows, numCols, filters_.first, filters_.first, j);
+          else if ( rowWave )
+            zerophase_2d(M_, S_, numRows, numCols, filters_.first, filters_.second, j);
+          else if ( colWave )
+            zerophase_2d(M_, S_, numRows, numCols, filters_.second, filters_.first, j);
+          else
+            zerophase_2d(M_, S_, numRows, numCols, filters_.second, filters_.second, j);
+        } // for
+        sink_.Block(level, band, firstRow, numRows, numCols, &M_[0]);
+      }
+
+    private:
+      const Filts& filters_;
+      int numLevels_;
+      BlockSink& sink_;
+      std::vector<T> M_, S_;
+    };
+
+  } // namespace Details
+
+
+  //==========
+  // modwt2d()
+  //==========
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename BlockSink
+           >
+  void modwt2d(const RowStore<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+               int numLevels, BlockSink& sink, std::size_t bandRows) {
+
+    const std::size_t R = X.Rows(), C = X.Cols();
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(R > 0 && C > 0, "modwt2d()", "empty input");
+    Ext::Assert<Ext::ArgumentError>(std::min(R, C) >= std::pow(2.0, expsz), "modwt2d()", "wavelet xfm exceeds sample size");
+    if ( bandRows == 0 || bandRows > R )
+      bandRows = R;
+
+    // LL of one level feeds the next ; two stores alternate
+    std::vector<RowStore<T>*> stores;
+    const RowStore<T>* in = &X;
+    const std::size_t L = static_cast<std::size_t>(wavefilt.size());
+    std::vector<T> xs, lo, hi, ts, cv, cw, ob;
+
+    try {
+      for ( int j = 0; j < numLevels; ++j ) {
+        RowStore<T>* out = 0;
+        if ( j + 1 < numLevels ) {
+          if ( stores.size() < 2 )
+            stores.push_back(new RowStore<T>(R, C, X.OnDisk()));
+          out = stores[j % 2];
+        }
+
+        // a band of output rows needs the (L-1)*2^j rows before it ; a single
+        //  band wraps around by itself within the column filter
+        const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j));
+        const std::size_t halo = (bandRows == R) ? 0 : (L - 1) * D;
+        const std::size_t nl = halo + bandRows;
+        xs.resize(nl * C), lo.resize(nl * C), hi.resize(nl * C);
+        ts.resize(nl * C), cv.resize(nl * C), cw.resize(nl * C), ob.resize(bandRows * C);
+
+        for ( std::size_t r0 = 0; r0 < R; r0 += bandRows ) {
+          const std::size_t nb = std::min(bandRows, R - r0);
+          const std::size_t n = halo + nb;
+          in->GetRows(static_cast<long long>(r0) - static_cast<long long>(halo), n, &xs[0]);
+          Details::filter_runs(&xs[0], n, C, wavefilt, scalefilt, j, &lo[0], &hi[0]);
+
+          // columns: transpose so each column is contiguous, filter, transpose back
+          for ( int half = 0; half < 2; ++half ) {
+            const Subband bands[2][2] = { { LL, LH }, { HL, HH } };
+            Details::transpose_tiled(half ? &hi[0] : &lo[0], n, C, C, &ts[0], n);
+            Details::filter_runs(&ts[0], C, n, wavefilt, scalefilt, j, &cv[0], &cw[0]);
+            for ( int k = 0; k < 2; ++k ) {
+              Details::transpose_tiled((k ? &cw[0] : &cv[0]) + halo, C, nb, n, &ob[0], C);
+              sink.Block(j+1, bands[half][k], r0, nb, C, &ob[0]);
+              if ( out && bands[half][k] == LL )
+                out->PutRows(r0, nb, &ob[0]);
+            } // for
+          } // for
+        } // for
+        in = out;
+      } // for
+    } catch(...) {
+      for ( std::size_t i = 0; i < stores.size(); ++i )
+        delete stores[i];
+      throw;
+    }
+    for ( std::size_t i = 0; i < stores.size(); ++i )
+      delete stores[i];
+  }
+
+
+  //==========
+  // modwt2d() : given a filter type
+  //==========
+  template <typename T, typename BlockSink>
+  void modwt2d(const RowStore<T>& X, Filter::FType filterType, int numLevels, BlockSink& sink,
+               std::size_t bandRows) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwt2d(X, filters.first, filters.second, numLevels, sink, bandRows);
+  }
+
+
+  //========
+  // mra2d()
+  //========
+  template <typename T, typename BlockSink>
+  void mra2d(const RowStore<T>& X, Filter::FType filterType, int numLevels, BlockSink& sink) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    Details::MRA2DSink<T, Filts, BlockSink> mraSink(filters, numLevels, sink);
+    modwt2d(X, filters.first, filters.second, numLevels, mraSink, 0);
+  }
+
+} // namespace WT
@@ -0,0 +1,158 @@
+/*
+  FILE: WT2D.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 15:20:48 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_2D_FRAMEWORK_HPP
+#define WT_2D_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* The 2D MODWT filters every row of a matrix with the 1D wavelet and scaling
+      filters, and then every column of both results, giving four subbands per
+      level.  The first letter of a subband names the filter applied along
+      rows and the second the filter applied along columns:
+        LL : scaling/scaling ; the input to the next level
+        LH : scaling along rows, wavelet along columns (horizontal edges)
+        HL : wavelet along rows, scaling along columns (vertical edges)
+        HH : wavelet/wavelet (diagonal detail)
+      Boundaries are periodic in both directions ; a reflected boundary is
+      obtained by reflecting the matrix before the transform (see the app).
+  */
+  enum Subband { LL = 0, LH = 1, HL = 2, HH = 3 };
+
+  std::string subbandName(Subband band);
+
+
+  //==========
+  // RowStore : a rows x cols matrix of T's kept in memory or in a temporary file
+  //==========
+  /*
+    Rows are only ever read and written in runs, so a store kept on disk lets
+    modwt2d() transform matrices that do not fit in RAM.  GetRows() wraps
+    around periodically when asked for rows past either end.
+  */
+  template <typename T>
+  class RowStore {
+  public:
+    RowStore(std::size_t cols, bool onDisk);
+    RowStore(std::size_t rows, std::size_t cols, bool onDisk);
+    ~RowStore();
+
+    void Append(const T* row);
+    void GetRows(long long first, std::size_t n, T* out) const;
+    void PutRows(std::size_t first, std::size_t n, const T* in);
+
+    std::size_t Rows() const { return(rows_); }
+    std::size_t Cols() const { return(cols_); }
+    bool OnDisk() const { return(file_ != 0); }
+
+  private:
+    RowStore(const RowStore&); // not copyable
+    RowStore& operator=(const RowStore&);
+
+    void io(bool write, std::size_t first, std::size_t n, T* buf) const;
+
+  private:
+    std::size_t rows_, cols_;
+    std::vector<T> mem_;
+    FILE* file_;
+  };
+
+
+  //============
+  // PrintBands : block sink writing each subband of each level to its own file
+  //============
+  /*
+    Files are named detailsBase-LH.level (and HL, HH) and llBase.level, with
+    one value per line in row-major order.  LL is written only at llLevel,
+    and an empty base name turns that family of subbands off.  Only the first
+    outRows x outCols values of each subband are written, which undoes the
+    doubling from a reflected boundary.
+  */
+  struct PrintBands {
+    PrintBands(const std::string& detailsBase, const std::string& llBase, int llLevel,
+               std::size_t outRows, std::size_t outCols);
+
+    template <typename T>
+    void Block(int level, Subband band, std::size_t firstRow, std::size_t numRows,
+               std::size_t numCols, const T* values);
+
+  private:
+    std::vector<PrintValues> bands_;
+    std::vector<int> levels_;
+    std::vector<bool> use_;
+    std::size_t outRows_, outCols_;
+  };
+
+
+  //==========
+  // modwt2d() : separable 2D maximal overlap discrete wavelet transform
+  //==========
+  // o 'X' is not modified
+  // o sink.Block(level, band, firstRow, numRows, numCols, values) receives
+  //    the row-major numRows x numCols rows starting at firstRow of one
+  //    subband.  Per level and row band, LL comes first, then LH, HL and HH.
+  // o bandRows == 0 holds each level in memory at once.  Otherwise the matrix
+  //    is processed bandRows rows at a time, reading the rows each band needs
+  //    (plus the filter's reach back in row order) from a RowStore, so with
+  //    an on-disk 'X' only a few bands live in RAM.  Intermediate LL levels
+  //    are kept wherever 'X' is.
+  //==========
+  template <
+            typename T,
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename BlockSink      // PrintBands or similar
+           >
+  void modwt2d(const RowStore<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+               int numLevels, BlockSink& sink, std::size_t bandRows = 0);
+
+  template <typename T, typename BlockSink>
+  void modwt2d(const RowStore<T>& X, Filter::FType filterType, int numLevels, BlockSink& sink,
+               std::size_t bandRows = 0);
+
+
+  //========
+  // mra2d() : 2D multiresolution analysis ; details and smooth
+  //========
+  // o sink.Block() receives the LH, HL and HH details of every level and the
+  //    smooth as LL at numLevels, each as one whole matrix
+  // o one level of subbands is held in memory at a time, even if 'X' is on disk
+  // o the details and smooth sum back to 'X'
+  //========
+  template <typename T, typename BlockSink>
+  void mra2d(const RowStore<T>& X, Filter::FType filterType, int numLevels, BlockSink& sink);
+
+} // namespace WT
+
+#include "WT2D.cpp"
+
+#endif // WT_2D_FRAMEWORK_HPP
@@ -0,0 +1,137 @@
+/*
+  FILE: WTBatch.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 19:14:08 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ParallelFor.hpp"
+#include "WTBatch.hpp"
+
+
+namespace WT {
+
+  //===========
+  // Workspace
+  //===========
+
+  template <typename Sequence>
+  template <typename Input>
+  Sequence& Workspace<Sequence>::Load(const Input& X) {
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    series_.clear();
+    series_.resize(N);
+    for ( std::size_t i = 0; i < N; ++i )
+      series_[i] = X[i];
+    return(series_);
+  }
+
+  template <typename Sequence>
+  const typename Workspace<Sequence>::Filters_t& Workspace<Sequence>::Filters(Filter::FType filterType) {
+    typename std::map<Filter::FType, Filters_t>::iterator i = filters_.find(filterType);
+    if ( i == filters_.end() )
+      i = filters_.insert(std::make_pair(filterType, Filter::getFilters<MODWT>(filterType))).first;
+    return(i->second);
+  }
+
+
+  namespace Details {
+
+    //============
+    // BatchRun : gives each worker of Ext::stealingFor() its own Workspace
+    //============
+    template <typename Workspace, typename Run>
+    struct BatchRun {
+      BatchRun(std::size_t threads, Run& run) : spaces_(threads), run_(run)
+        { /* */ }
+
+      void operator()(std::size_t job, std::size_t worker)
+        { run_(job, spaces_[worker]); }
+
+      std::vector<Workspace> spaces_;
+      Run& run_;
+    };
+
+    //============
+    // ModwtRun : one modwt_batch() job
+    //============
+    template <typename Jobs>
+    struct ModwtRun {
+      explicit ModwtRun(Jobs& jobs) : jobs_(jobs)
+        { /* */ }
+
+      template <typename Workspace>
+      void operator()(std::size_t i, Workspace& space) {
+        typename Jobs::value_type& job = jobs_[i];
+        const BatchOptions& opts = job.options_;
+        if ( opts.filterType_ == Filter::Haar ) { // haar_modwt() leaves its input alone
+          haar_modwt(*job.series_, opts.numLevels_, *job.vop_, *job.wop_);
+          return;
+        }
+        const typename Workspace::Filters_t& filters = space.Filters(opts.filterType_);
+        modwt(space.Load(*job.series_), filters.first, filters.second, opts.numLevels_, *job.vop_, *job.wop_);
+      }
+
+      Jobs& jobs_;
+    };
+
+  } // namespace Details
+
+
+  //=========
+  // batch()
+  //=========
+  template <typename Workspace, typename Run>
+  void batch(const std::vector<std::size_t>& sizes, std::size_t threads, Run& run) {
+    std::vector< std::pair<std::size_t, std::size_t> > bySize;
+    for ( std::size_t i = 0; i < sizes.size(); ++i )
+      bySize.push_back(std::make_pair(sizes[i], sizes.size() - i)); // ties keep input order
+    std::sort(bySize.rbegin(), bySize.rend());
+    std::vector<std::size_t> order;
+    for ( std::size_t i = 0; i < bySize.size(); ++i )
+      order.push_back(sizes.size() - bySize[i].second);
+
+    threads = std::max<std::size_t>(1, std::min(threads, sizes.size()));
+    Details::BatchRun<Workspace, Run> workers(threads, run);
+    Ext::stealingFor(order, threads, workers);
+  }
+
+  //===============
+  // modwt_batch()
+  //===============
+  template <typename Sequence, typename VOp, typename WOp>
+  void modwt_batch(std::vector< BatchJob<Sequence, VOp, WOp> >& jobs, std::size_t threads) {
+    typedef typename Sequence::value_type T;
+    typedef std::vector< BatchJob<Sequence, VOp, WOp> > Jobs;
+
+    std::vector<std::size_t> sizes;
+    for ( std::size_t i = 0; i < jobs.size(); ++i )
+      sizes.push_back(static_cast<std::size_t>(jobs[i].series_->size()));
+    Details::ModwtRun<Jobs> run(jobs);
+    batch< Workspace< std::vector<T> > >(sizes, threads, run);
+  }
+
+} // namespace WT
@@ -0,0 +1,128 @@
+/*
+  FILE: WTBatch.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 19:14:08 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_BATCH_FRAMEWORK_HPP
+#define WT_BATCH_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* Batches: many small, independent series transformed in one process.
+      Jobs run on a work-stealing pool (Ext::stealingFor()), largest first,
+      and each worker keeps a Workspace whose series buffer and filters are
+      reused from one job to the next rather than built anew each time.
+  */
+
+  //===========
+  // Workspace : one worker's buffers, reused across the jobs it runs
+  //===========
+  // o Series() keeps its capacity between jobs ; Sequence needs clear(),
+  //    resize() and operator[] (vector<T>, Ext::MappedArray<T>)
+  // o Filters() builds each filter type's MODWT filters once
+  //===========
+  template <typename Sequence>
+  struct Workspace {
+    typedef std::pair<Filter::WaveletFilter, Filter::ScalingFilter> Filters_t;
+
+    Sequence& Series()
+      { return(series_); }
+
+    template <typename Input>
+    Sequence& Load(const Input& X);
+
+    const Filters_t& Filters(Filter::FType filterType);
+
+  private:
+    Sequence series_;
+    std::map<Filter::FType, Filters_t> filters_;
+  };
+
+  //==============
+  // BatchOptions : how one batch job's series is transformed
+  //==============
+  struct BatchOptions {
+    explicit BatchOptions(Filter::FType filterType = Filter::LA8, int numLevels = 4)
+      : filterType_(filterType), numLevels_(numLevels)
+      { /* */ }
+
+    Filter::FType filterType_;
+    int numLevels_;
+  };
+
+  //==========
+  // BatchJob : a series, its options and the ops (sinks) that receive its results
+  //==========
+  template <typename Sequence, typename VOp, typename WOp>
+  struct BatchJob {
+    BatchJob(const Sequence& X, const BatchOptions& options, VOp& vop, WOp& wop)
+      : series_(&X), options_(options), vop_(&vop), wop_(&wop)
+      { /* */ }
+
+    const Sequence* series_;
+    BatchOptions options_;
+    VOp* vop_;
+    WOp* wop_;
+  };
+
+  //=========
+  // batch() : runs jobs 0..sizes.size()-1 on 'threads' workers, largest first
+  //=========
+  // o sizes[i] is the expected cost of job i, such as its series length
+  // o run(i, workspace) is called once per job, from some worker, with that
+  //    worker's own Workspace
+  // o the first exception thrown by run() stops the batch and is rethrown
+  //=========
+  template <
+            typename Workspace, // default constructible ; one per worker
+            typename Run        // run(std::size_t job, Workspace&)
+           >
+  void batch(const std::vector<std::size_t>& sizes, std::size_t threads, Run& run);
+
+  //===============
+  // modwt_batch() : modwt() of every job's series, in parallel
+  //===============
+  // o each series is copied into its worker's Workspace, so it is not
+  //    modified, unlike with modwt()
+  // o a job's ops are called from one thread, exactly as modwt() would call
+  //    them, but different jobs run at once: ops must not share state
+  //===============
+  template <
+            typename Sequence, // vector<T>, deque<T>, ...
+            typename VOp,      // Op called for each scaling coeff calculated
+            typename WOp       // Op called for each wavelet coeff calculated
+           >
+  void modwt_batch(std::vector< BatchJob<Sequence, VOp, WOp> >& jobs, std::size_t threads);
+
+} // namespace WT
+
+#include "WTBatch.cpp"
+
+#endif // WT_BATCH_FRAMEWORK_HPP
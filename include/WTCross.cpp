@@ -0,0 +1,161 @@
+/*
+  FILE: WTCross.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 17:18:36 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTCross.hpp"
+
+
+namespace WT {
+
+  namespace Details {
+
+    //======================
+    // modwt_forward_pair() : modwt_forward() for two series sharing filter loads
+    //======================
+    template <
+              typename Container,
+              typename WaveletFilter,
+              typename ScalingFilter,
+              typename PairOp
+             >
+    void modwt_forward_pair(const Container& Xi, const Container& Yi, const WaveletFilter& wavefilt,
+                            const ScalingFilter& scalefilt, int j, Container& Xj, Container& Yj,
+                            PairOp& pairOp) {
+
+      typedef typename Container::value_type T;
+      const std::size_t N = static_cast<std::size_t>(Xi.size()); // Yi.size() == Xi.size()
+      const std::size_t L = static_cast<std::size_t>(wavefilt.size());
+      const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j)); // asserted <= N by caller
+      std::size_t k = 0;
+
+      for ( std::size_t t = 0; t < N; k = static_cast<std::size_t>(++t) ) {
+        // same arithmetic as modwt_forward() so either route gives identical values
+        T vx = scalefilt[0] * Xi[t], vy = scalefilt[0] * Yi[t];
+        T wx = wavefilt[0] * Xi[t], wy = wavefilt[0] * Yi[t];
+
+        for ( std::size_t l = 1; l < L; ++l ) {
+          if ( k >= D )
+            k -= D;
+          else
+            k = static_cast<std::size_t>(N + k - D);
+          const T x = Xi[k], y = Yi[k];
+          vx += scalefilt[l] * x, vy += scalefilt[l] * y;
+          wx += wavefilt[l] * x, wy += wavefilt[l] * y;
+        } // for
+
+        Xj[t] = vx, Yj[t] = vy;
+        pairOp(wx, wy);
+      } // for
+    }
+
+  } // namespace Details
+
+
+  //============
+  // modwt_pair()
+  //============
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename PairOp
+           >
+  void modwt_pair(Sequence& X, Sequence& Y, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                  int numLevels, PairOp& pairOp) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() == Y.size(), "modwt_pair()", "series differ in length");
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_pair()", "wavelet xfm exceeds sample size");
+
+    Sequence Xk(X.size(), 0), Yk(Y.size(), 0);
+    Sequence *Xi = &X, *Yi = &Y, *Xj = &Xk, *Yj = &Yk;
+    for ( int j = 0; j < numLevels; ++j ) {
+      pairOp.Level(j+1);
+      Details::modwt_forward_pair(*Xi, *Yi, wavefilt, scalefilt, j, *Xj, *Yj, pairOp);
+      std::swap(Xi, Xj);
+      std::swap(Yi, Yj);
+    } // for
+  }
+
+
+  //=================
+  // ReferenceSeries
+  //=================
+
+  template <typename Sequence, typename WaveletFilter, typename ScalingFilter>
+  ReferenceSeries<Sequence, WaveletFilter, ScalingFilter>::ReferenceSeries(const Sequence& ref,
+                                                                           const WaveletFilter& wavefilt,
+                                                                           const ScalingFilter& scalefilt,
+                                                                           int numLevels)
+      : wavefilt_(wavefilt), scalefilt_(scalefilt), numLevels_(numLevels),
+        N_(static_cast<std::size_t>(ref.size())), W_(N_ * static_cast<std::size_t>(numLevels), T(0)) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(!ref.empty(), "ReferenceSeries", "empty input");
+    Ext::Assert<Ext::ArgumentError>(ref.size() >= std::pow(2.0, expsz), "ReferenceSeries", "wavelet xfm exceeds sample size");
+
+    Sequence A(ref), B(ref.size(), 0);
+    Sequence *Vi = &A, *Vj = &B;
+    DoNothing nothing;
+    for ( int j = 0; j < numLevels; ++j ) {
+      T* Wj = W_.data() + j * N_;
+      Details::modwt_forward(*Vi, wavefilt_, scalefilt_, j, *Vj, Wj, nothing, nothing);
+      std::swap(Vi, Vj);
+    } // for
+  }
+
+  template <typename Sequence, typename WaveletFilter, typename ScalingFilter>
+  template <typename PairOp>
+  void ReferenceSeries<Sequence, WaveletFilter, ScalingFilter>::Pair(Sequence& track, PairOp& pairOp) const {
+    Ext::Assert<Ext::ArgumentError>(static_cast<std::size_t>(track.size()) == N_, "ReferenceSeries::Pair()",
+                                    "series differ in length");
+
+    // modwt_forward() with an op that zips in the stored reference coefficients
+    struct Zip {
+      Zip(const T* ref, PairOp& op) : ref_(ref), op_(op)
+        { /* */ }
+      void operator()(const T& w)
+        { op_(*ref_++, w); }
+      const T* ref_;
+      PairOp& op_;
+    };
+
+    Sequence Vk(track.size(), 0);
+    Sequence *Vi = &track, *Vj = &Vk;
+    DoNothing nothing;
+    for ( int j = 0; j < numLevels_; ++j ) {
+      pairOp.Level(j+1);
+      Zip zip(W_.data() + j * N_, pairOp);
+      Details::modwt_forward(*Vi, wavefilt_, scalefilt_, j, *Vj, nothing, zip);
+      std::swap(Vi, Vj);
+    } // for
+  }
+
+} // namespace WT
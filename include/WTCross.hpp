@@ -0,0 +1,94 @@
+/*
+  FILE: WTCross.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 17:18:36 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_CROSS_FRAMEWORK_HPP
+#define WT_CROSS_FRAMEWORK_HPP
+
+#include <cstddef>
+
+#include "MappedArray.hpp"
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* Paired transforms hand the wavelet coefficients of two series to one op,
+      pairOp(wx, wy), one time point at a time, after pairOp.Level(j).  See
+      WaveletCrossCorrelation in WTOps.hpp.
+  */
+
+  //============
+  // modwt_pair() : modwt() of two equal-length series in lockstep
+  //============
+  // o 'X' and 'Y' are overwritten, as with modwt()
+  // o each filter coefficient is loaded once for both series
+  //============
+  template <
+            typename Sequence,      // 'X' and 'Y' contain N measurement values each
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename PairOp         // Op called with each pair of wavelet coeffs (N per level)
+           >
+  void modwt_pair(Sequence& X, Sequence& Y, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                  int numLevels, PairOp& pairOp);
+
+
+  //=================
+  // ReferenceSeries : one series transformed once, to be paired with many others
+  //=================
+  /*
+    The constructor keeps all numLevels levels of the reference's wavelet
+    coefficients in one contiguous buffer.  Each Pair() call then only
+    transforms 'track' (overwriting it) and hands pairOp the reference and
+    track coefficients in the order modwt_pair() would.
+  */
+  template <
+            typename Sequence,
+            typename WaveletFilter = Filter::WaveletFilter,
+            typename ScalingFilter = Filter::ScalingFilter
+           >
+  struct ReferenceSeries {
+    ReferenceSeries(const Sequence& ref, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                    int numLevels);
+
+    template <typename PairOp>
+    void Pair(Sequence& track, PairOp& pairOp) const;
+
+    std::size_t size() const { return(N_); }
+
+  private:
+    typedef typename Sequence::value_type T;
+
+    WaveletFilter wavefilt_;
+    ScalingFilter scalefilt_;
+    int numLevels_;
+    std::size_t N_;
+    Ext::MappedArray<T> W_; // W_1 | W_2 | ... | W_J
+  };
+
+} // namespace WT
+
+#include "WTCross.cpp"
+
+#endif // WT_CROSS_FRAMEWORK_HPP
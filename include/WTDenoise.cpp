@@ -0,0 +1,196 @@
+/*
+  FILE: WTDenoise.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 16:41:09 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "MappedArray.hpp"
+#include "WTDenoise.hpp"
+
+
+namespace WT {
+
+  //===========
+  // Threshold
+  //===========
+
+  Threshold::Rule Threshold::selectRule(const std::string& s) {
+    std::string cpy(s);
+    for ( std::string::size_type i = 0; i < cpy.size(); ++i )
+      cpy[i] = std::tolower(cpy[i]);
+    if ( cpy == "universal" )
+      return(UNIVERSAL);
+    else if ( cpy == "sure" )
+      return(SURE);
+    throw(Ext::UserError("Unknown threshold rule: " + s, "expect universal or sure"));
+  }
+
+  Threshold::Shrink Threshold::selectShrink(const std::string& s) {
+    std::string cpy(s);
+    for ( std::string::size_type i = 0; i < cpy.size(); ++i )
+      cpy[i] = std::tolower(cpy[i]);
+    if ( cpy == "soft" )
+      return(SOFT);
+    else if ( cpy == "hard" )
+      return(HARD);
+    throw(Ext::UserError("Unknown shrinkage: " + s, "expect soft or hard"));
+  }
+
+
+  namespace Details {
+
+    //============
+    // madSigma() : MODWT noise level from W_1 ; 'scratch' holds N values
+    //============
+    template <typename T, typename Sequence>
+    double madSigma(const T* W1, std::size_t N, Sequence& scratch) {
+      for ( std::size_t t = 0; t < N; ++t )
+        scratch[t] = static_cast<typename Sequence::value_type>(std::fabs(W1[t]));
+      typename Sequence::value_type* mid = &scratch[0] + N / 2;
+      std::nth_element(&scratch[0], mid, &scratch[0] + N);
+      return(std::sqrt(2.0) * static_cast<double>(*mid) / 0.6745);
+    }
+
+    //===============
+    // sureLambda() : Stein's unbiased risk for soft shrinkage, minimized
+    //===============
+    // o risk(lambda) = N - 2 #{|x| <= lambda} + sum min(x^2, lambda^2) for x = W / sigma
+    // o only the N sorted squares are needed ; 'scratch' holds them
+    //===============
+    template <typename T, typename Sequence>
+    double sureLambda(const T* Wj, std::size_t N, double sigma, double universal, Sequence& scratch) {
+      if ( sigma <= 0 )
+        return(0);
+      for ( std::size_t t = 0; t < N; ++t ) {
+        const double x = static_cast<double>(Wj[t]) / sigma;
+        scratch[t] = static_cast<typename Sequence::value_type>(x * x);
+      } // for
+      std::sort(&scratch[0], &scratch[0] + N);
+
+      double best = static_cast<double>(N), bestSq = 0, cum = 0; // risk at lambda = 0 is N
+      for ( std::size_t k = 0; k < N; ++k ) {
+        const double a = static_cast<double>(scratch[k]);
+        cum += a;
+        const double risk = static_cast<double>(N) - 2.0 * (k + 1) + cum + (N - k - 1) * a;
+        if ( risk < best )
+          best = risk, bestSq = a;
+      } // for
+      return(std::min(std::sqrt(bestSq) * sigma, universal));
+    }
+
+    //==========
+    // shrink() : in place
+    //==========
+    template <typename T>
+    void shrink(T* Wj, std::size_t N, double lambda, Threshold::Shrink how) {
+      const T lam = static_cast<T>(lambda);
+      for ( std::size_t t = 0; t < N; ++t ) {
+        const T w = Wj[t];
+        if ( w <= lam && w >= -lam )
+          Wj[t] = 0;
+        else if ( how == Threshold::SOFT )
+          Wj[t] = (w > 0) ? w - lam : w + lam;
+      } // for
+    }
+
+  } // namespace Details
+
+
+  //===========
+  // denoise()
+  //===========
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp
+           >
+  void denoise(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+               Threshold::Rule rule, Threshold::Shrink shrink, VOp& vop) {
+
+    typedef typename Sequence::value_type T;
+    Ext::Assert<Ext::ArgumentError>(!X.empty(), "denoise()", "empty input");
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "denoise()", "wavelet xfm exceeds sample size");
+
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    Ext::MappedArray<T> W(N * static_cast<std::size_t>(numLevels), T(0)); // W_1 | W_2 | ... | W_J
+    Sequence Vk(N, 0);
+    Sequence* Vi = &X;
+    Sequence* Vj = &Vk;
+    DoNothing nothing;
+
+    // forward: V_J ends up in *Vi
+    for ( int j = 0; j < numLevels; ++j ) {
+      T* Wj = W.data() + j * N;
+      Details::modwt_forward(*Vi, wavefilt, scalefilt, j, *Vj, Wj, nothing, nothing);
+      std::swap(Vi, Vj);
+    } // for
+
+    // thresholds: *Vj is free as scratch until the inverse
+    const double sigma = Details::madSigma(W.data(), N, *Vj);
+    const double logTerm = std::sqrt(2.0 * std::log(static_cast<double>(N)));
+    for ( int j = 0; j < numLevels; ++j ) {
+      T* Wj = W.data() + j * N;
+      const double sigmaj = sigma / std::pow(2.0, (j + 1) / 2.0);
+      const double universal = sigmaj * logTerm;
+      const double lambda = (rule == Threshold::SURE)
+                              ? Details::sureLambda(Wj, N, sigmaj, universal, *Vj)
+                              : universal;
+      Details::shrink(Wj, N, lambda, shrink);
+    } // for
+
+    // inverse
+    for ( int j = numLevels - 1; j >= 0; --j ) {
+      const T* Wj = W.data() + j * N;
+      vop.Level(numLevels - j); // counting backwards
+      Details::imodwt_backward(*Vi, Wj, wavefilt, scalefilt, j, *Vj, vop);
+      std::swap(Vi, Vj);
+    } // for
+  }
+
+
+  //===========
+  // denoise() : given a filter type
+  //===========
+  template <
+            typename Sequence,
+            typename VOp
+           >
+  void denoise(Sequence& X, Filter::FType filterType, int numLevels,
+               Threshold::Rule rule, Threshold::Shrink shrink, VOp& vop) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    denoise(X, filters.first, filters.second, numLevels, rule, shrink, vop);
+  }
+
+} // namespace WT
@@ -0,0 +1,86 @@
+/*
+  FILE: WTDenoise.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 16:41:09 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_DENOISE_FRAMEWORK_HPP
+#define WT_DENOISE_FRAMEWORK_HPP
+
+#include <string>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  //===========
+  // Threshold : how denoise() picks and applies a threshold per level
+  //===========
+  /*
+    The noise level comes from the median absolute deviation of W_1, and for
+    MODWT coefficients sigma = sqrt(2) * MAD(W_1) / 0.6745 (Percival & Walden
+    section 10.5).  Level j coefficients then have noise sigma_j = sigma / 2^(j/2).
+      UNIVERSAL : lambda_j = sigma_j * sqrt(2 log N)
+      SURE      : the lambda_j minimizing Stein's unbiased risk estimate for
+                  soft shrinkage of level j, never above the universal one
+    SOFT shrinkage moves every kept coefficient toward zero by lambda_j,
+    while HARD shrinkage only zeros those with |W| <= lambda_j.
+  */
+  struct Threshold {
+    enum Rule { UNIVERSAL, SURE };
+    enum Shrink { SOFT, HARD };
+
+    static Rule selectRule(const std::string& s);
+    static Shrink selectShrink(const std::string& s);
+  };
+
+
+  //===========
+  // denoise() : modwt(), shrink the wavelet coefficients in place, then imodwt()
+  //===========
+  // o 'X' is overwritten
+  // o all J levels of wavelet coefficients sit in one contiguous J*N buffer ;
+  //    with 'X' and one scratch Sequence that makes J+2 N-sized buffers in all
+  // o vop.Level(k) is called for k = 1..numLevels, counting back toward the
+  //    input like smooth(), and the N denoised values come with k = numLevels
+  //===========
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename VOp            // Op called for each inverse value calculated
+           >
+  void denoise(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+               Threshold::Rule rule, Threshold::Shrink shrink, VOp& vop);
+
+  template <
+            typename Sequence,
+            typename VOp
+           >
+  void denoise(Sequence& X, Filter::FType filterType, int numLevels,
+               Threshold::Rule rule, Threshold::Shrink shrink, VOp& vop);
+
+} // namespace WT
+
+#include "WTDenoise.cpp"
+
+#endif // WT_DENOISE_FRAMEWORK_HPP
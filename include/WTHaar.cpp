@@ -0,0 +1,119 @@
+/*
+  FILE: WTHaar.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 13:05:33 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTHaar.hpp"
+
+
+namespace WT {
+
+  namespace Haar {
+
+    //==============
+    // PrefixEngine
+    //==============
+
+    template <typename Acc>
+    template <typename Sequence>
+    PrefixEngine<Acc>::PrefixEngine(const Sequence& X) : prefix_(X.size() + 1, Acc(0)) {
+      Ext::Assert<Ext::ArgumentError>(!X.empty(), "Haar::PrefixEngine", "empty input");
+      const std::size_t N = static_cast<std::size_t>(X.size());
+      for ( std::size_t t = 0; t < N; ++t )
+        prefix_[t+1] = prefix_[t] + static_cast<Acc>(X[t]);
+    }
+
+    template <typename Acc>
+    std::size_t PrefixEngine<Acc>::size() const
+      { return(prefix_.size() - 1); }
+
+    template <typename Acc>
+    inline Acc PrefixEngine<Acc>::through(long long k) const {
+      // windows at deep levels may wrap around the series more than once
+      const long long N = static_cast<long long>(size());
+      long long q = k / N, r = k % N;
+      if ( r < 0 )
+        r += N, --q;
+      return(static_cast<Acc>(q) * prefix_[N] + prefix_[r]);
+    }
+
+    template <typename Acc>
+    inline Acc PrefixEngine<Acc>::window(std::size_t t, std::size_t m) const {
+      const long long end = static_cast<long long>(t) + 1;
+      const long long start = end - static_cast<long long>(m);
+      if ( start >= 0 ) // common case: no wrap
+        return(prefix_[end] - prefix_[start]);
+      return(through(end) - through(start));
+    }
+
+    template <typename Acc>
+    inline double PrefixEngine<Acc>::Scaling(int level, std::size_t t) const {
+      const std::size_t m = static_cast<std::size_t>(1) << level;
+      return(static_cast<double>(window(t, m)) / m);
+    }
+
+    template <typename Acc>
+    inline double PrefixEngine<Acc>::Wavelet(int level, std::size_t t) const {
+      const std::size_t m = static_cast<std::size_t>(1) << level;
+      const std::size_t h = m / 2;
+      const std::size_t N = size();
+      const std::size_t older = (t >= h % N) ? t - h % N : t + N - h % N;
+      return(static_cast<double>(window(t, h) - window(older, h)) / m);
+    }
+
+  } // namespace Haar
+
+
+  //==============
+  // haar_modwt()
+  //==============
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void haar_modwt(const Sequence& X, int numLevels, VOp& vop, WOp& wop) {
+    typedef typename Sequence::value_type T;
+    typedef typename Haar::ResultFor<T>::type R;
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "haar_modwt()", "wavelet xfm exceeds sample size");
+    Haar::PrefixEngine<typename Haar::AccumFor<T>::type> engine(X);
+
+    const std::size_t N = engine.size();
+    for ( int j = 1; j <= numLevels; ++j ) {
+      vop.Level(j);
+      wop.Level(j);
+      for ( std::size_t t = 0; t < N; ++t ) {
+        vop(static_cast<R>(engine.Scaling(j, t)));
+        wop(static_cast<R>(engine.Wavelet(j, t)));
+      } // for
+    } // for
+  }
+
+} // namespace WT
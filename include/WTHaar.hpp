@@ -0,0 +1,98 @@
+/*
+  FILE: WTHaar.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 13:05:33 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef WT_HAAR_FRAMEWORK_HPP
+#define WT_HAAR_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace WT {
+
+  namespace Haar {
+
+    //===============
+    // PrefixEngine : Haar MODWT coefficients straight from prefix sums
+    //===============
+    /*
+      With the Haar filter, the level-j MODWT scaling coefficient V_j[t] is the
+      mean of the 2^j values ending at t, and the wavelet coefficient W_j[t]
+      is half the difference between the means of the newest and the oldest
+      2^(j-1) of those values (wrapping periodically).  Both are differences of
+      one prefix-sum array, so any coefficient at any level costs O(1) and no
+      level depends on the one below it.
+      Acc is the prefix-sum type: 'long long' gives exact sums for integer
+      (count) data, 'double' is used for floating point input.  AccumFor<T>
+      picks the right one.
+    */
+    template <typename Acc>
+    struct PrefixEngine {
+      template <typename Sequence>
+      explicit PrefixEngine(const Sequence& X);
+
+      std::size_t size() const;
+      double Scaling(int level, std::size_t t) const; // V_level[t] ; level >= 1
+      double Wavelet(int level, std::size_t t) const; // W_level[t] ; level >= 1
+
+    private:
+      Acc through(long long k) const; // sum of the periodic extension over [0,k)
+      Acc window(std::size_t t, std::size_t m) const; // m values ending at t
+
+      std::vector<Acc> prefix_; // N+1 partial sums
+    };
+
+    template <typename T>
+    struct AccumFor {
+      typedef typename std::conditional<std::is_integral<T>::value, long long, double>::type type;
+    };
+
+    // coefficient type handed to ops: same as input for floating point, double for integers
+    template <typename T>
+    struct ResultFor {
+      typedef typename std::conditional<std::is_integral<T>::value, double, T>::type type;
+    };
+
+  } // namespace Haar
+
+
+  //==============
+  // haar_modwt() : modwt() for the Haar filter via Haar::PrefixEngine
+  //==============
+  // o 'X' is not modified, unlike modwt()
+  // o ops are called exactly as modwt() would call them
+  // o integer input sequences use exact 64-bit prefix sums
+  //==============
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void haar_modwt(const Sequence& X, int numLevels, VOp& vop, WOp& wop);
+
+} // namespace WT
+
+#include "WTHaar.cpp"
+
+#endif // WT_HAAR_FRAMEWORK_HPP
@@ -0,0 +1,195 @@
+/*
+  FILE: WTMulti.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 20:03:51 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTHaar.hpp"
+#include "WTMulti.hpp"
+
+
+namespace WT {
+
+  //=============
+  // MultiSeries
+  //=============
+
+  template <typename T>
+  MultiSeries<T>::MultiSeries(std::size_t numSeries, std::size_t length)
+      : numSeries_(numSeries), stride_(((numSeries + Lanes - 1) / Lanes) * Lanes), length_(0) {
+    Ext::Assert<Ext::ArgumentError>(numSeries > 0, "MultiSeries", "no series");
+    Resize(length);
+  }
+
+  template <typename T>
+  void MultiSeries<T>::Append(const T* row) {
+    data_.resize(data_.size() + stride_, T(0));
+    T* r = Row(length_++);
+    for ( std::size_t s = 0; s < numSeries_; ++s )
+      r[s] = row[s];
+  }
+
+  template <typename T>
+  void MultiSeries<T>::Resize(std::size_t length) {
+    data_.resize(length * stride_, T(0));
+    length_ = length;
+  }
+
+
+  namespace Details {
+
+    //=================
+    // multi_forward() : modwt_forward() on every series of Vi at once
+    //=================
+    // o 'Wj' is one row of scratch
+    // o sums are formed exactly as in modwt_forward()
+    //=================
+    template <
+              typename T,
+              typename WaveletFilter,
+              typename ScalingFilter,
+              typename ContVOps,
+              typename ContWOps
+             >
+    void multi_forward(const MultiSeries<T>& Vi, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                       int j, MultiSeries<T>& Vj, std::vector<T>& Wj, ContVOps& vops, ContWOps& wops) {
+
+      const std::size_t N = Vi.size();
+      const std::size_t K = Vi.Series(), S = Vi.Stride();
+      const std::size_t L = static_cast<std::size_t>(wavefilt.size()); // wavefilt.size() == scalefilt.size()
+      const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j)); // assumed <= N ; asserted by caller
+      T* w = &Wj[0];
+      std::size_t k = 0;
+
+      for ( std::size_t t = 0; t < N; k = static_cast<std::size_t>(++t) ) {
+        T* v = Vj.Row(t);
+        const T* x = Vi.Row(t);
+        for ( std::size_t s = 0; s < S; ++s ) {
+          v[s] = scalefilt[0] * x[s];
+          w[s] = wavefilt[0] * x[s];
+        } // for
+
+        for ( std::size_t l = 1; l < L; ++l ) {
+          if ( k >= D )
+            k -= D;
+          else
+            k = static_cast<std::size_t>(N + k - D);
+          const T* xk = Vi.Row(k);
+          const double g = scalefilt[l], h = wavefilt[l];
+          for ( std::size_t s = 0; s < S; ++s ) {
+            v[s] += g * xk[s];
+            w[s] += h * xk[s];
+          } // for
+        } // for
+
+        for ( std::size_t s = 0; s < K; ++s ) {
+          vops[s](v[s]);
+          wops[s](w[s]);
+        } // for
+      } // for
+    }
+
+  } // namespace Details
+
+
+  //===============
+  // modwt_multi()
+  //===============
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename ContVOps,
+            typename ContWOps
+           >
+  void modwt_multi(MultiSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                   int numLevels, ContVOps& vops, ContWOps& wops) {
+
+    double expsz = numLevels - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_multi()", "wavelet xfm exceeds sample size");
+    Ext::Assert<Ext::ArgumentError>(vops.size() == X.Series() && wops.size() == X.Series(),
+                                    "modwt_multi()", "need one op per series");
+
+    MultiSeries<T> const *Vi = &X;
+    MultiSeries<T> Vk(X.Series(), X.size());
+    MultiSeries<T>* Vj = &Vk;
+    std::vector<T> Wj(X.Stride(), 0);
+
+    for ( int j = 0; j < numLevels; ++j ) {
+      for ( std::size_t s = 0; s < X.Series(); ++s ) {
+        vops[s].Level(j+1);
+        wops[s].Level(j+1);
+      } // for
+      Details::multi_forward(*Vi, wavefilt, scalefilt, j, *Vj, Wj, vops, wops);
+      Vi = Vj;
+      Vj = (Vi == &Vk) ? &X : &Vk;
+    } // for
+  }
+
+  template <typename T, typename ContVOps, typename ContWOps>
+  void modwt_multi(MultiSeries<T>& X, Filter::FType filterType, int numLevels,
+                   ContVOps& vops, ContWOps& wops) {
+    if ( filterType == Filter::Haar ) { // no cascade to share ; one prefix-sum engine per series
+      typedef typename Haar::AccumFor<T>::type Acc;
+      typedef typename Haar::ResultFor<T>::type R;
+      double expsz = numLevels - 1;
+      Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwt_multi()", "wavelet xfm exceeds sample size");
+      Ext::Assert<Ext::ArgumentError>(vops.size() == X.Series() && wops.size() == X.Series(),
+                                      "modwt_multi()", "need one op per series");
+      const std::size_t N = X.size(), K = X.Series();
+      std::vector< Haar::PrefixEngine<Acc> > engines;
+      std::vector<T> one(N);
+      for ( std::size_t s = 0; s < K; ++s ) {
+        for ( std::size_t t = 0; t < N; ++t )
+          one[t] = X.Row(t)[s];
+        engines.push_back(Haar::PrefixEngine<Acc>(one));
+      } // for
+
+      // same calls per op as haar_modwt(), and every series at a position in turn
+      for ( int j = 1; j <= numLevels; ++j ) {
+        for ( std::size_t s = 0; s < K; ++s ) {
+          vops[s].Level(j);
+          wops[s].Level(j);
+        } // for
+        for ( std::size_t t = 0; t < N; ++t ) {
+          for ( std::size_t s = 0; s < K; ++s ) {
+            vops[s](static_cast<R>(engines[s].Scaling(j, t)));
+            wops[s](static_cast<R>(engines[s].Wavelet(j, t)));
+          } // for
+        } // for
+      } // for
+      return;
+    }
+
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwt_multi(X, filters.first, filters.second, numLevels, vops, wops);
+  }
+
+} // namespace WT
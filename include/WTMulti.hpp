@@ -0,0 +1,114 @@
+/*
+  FILE: WTMulti.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 20:03:51 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_MULTI_FRAMEWORK_HPP
+#define WT_MULTI_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* Many series of one length, such as replicate tracks, transformed together.
+      The series are stored interleaved (structure of arrays): position t of
+      every series sits in one contiguous row.  The MODWT kernel then does the
+      index arithmetic, the periodic wraparound and the filter loads once per
+      t and applies each tap to a whole row, a loop compilers turn into vector
+      instructions across series.  Rows are padded to a multiple of Lanes so
+      those loops need no remainder handling.
+  */
+
+  //=============
+  // MultiSeries : numSeries series of size() values each, stored by position
+  //=============
+  template <typename T>
+  class MultiSeries {
+  public:
+    typedef T value_type;
+    enum { Lanes = (32 / sizeof(T) > 0) ? 32 / sizeof(T) : 1 }; // a 256-bit vector
+
+    explicit MultiSeries(std::size_t numSeries, std::size_t length = 0);
+
+    void Append(const T* row); // one value per series
+    void Resize(std::size_t length);
+
+    std::size_t size() const
+      { return(length_); }
+
+    std::size_t Series() const
+      { return(numSeries_); }
+
+    std::size_t Stride() const
+      { return(stride_); }
+
+    T* Row(std::size_t t)
+      { return(&data_[t * stride_]); }
+
+    const T* Row(std::size_t t) const
+      { return(&data_[t * stride_]); }
+
+  private:
+    std::size_t numSeries_, stride_, length_;
+    std::vector<T> data_;
+  };
+
+
+  //===============
+  // modwt_multi() : modwt() of every series in X at once
+  //===============
+  // o 'vops' and 'wops' hold one op per series (X.Series() of each) ; each op
+  //    sees exactly the calls modwt() would make for its series alone
+  // o within a level, ops are called position by position, every series at
+  //    a position in turn (see PrintColumns)
+  // o results equal those of modwt() on each series
+  // o like modwt(), 'X' is overwritten
+  //===============
+  template <
+            typename T,
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ContVOps,      // Container of ops, one per series, for scaling coeffs
+            typename ContWOps       // Container of ops, one per series, for wavelet coeffs
+           >
+  void modwt_multi(MultiSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                   int numLevels, ContVOps& vops, ContWOps& wops);
+
+
+  //===============
+  // modwt_multi() : overload taking a filter type
+  //===============
+  // o Filter::Haar uses haar_modwt()'s prefix sums for every series, as modwt() does
+  //===============
+  template <typename T, typename ContVOps, typename ContWOps>
+  void modwt_multi(MultiSeries<T>& X, Filter::FType filterType, int numLevels,
+                   ContVOps& vops, ContWOps& wops);
+
+} // namespace WT
+
+#include "WTMulti.cpp"
+
+#endif // WT_MULTI_FRAMEWORK_HPP
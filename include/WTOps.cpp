@@ -22,16 +22,29 @@
 //    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <limits>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
 #include "Assertion.hpp"
 #include "Exception.hpp"
 #include "PrintTypes.hpp"
 #include "WTOps.hpp"
+#include "WTWriter.hpp"
 
 
 namespace WT {
@@ -43,21 +56,108 @@ namespace WT {
 
   PrintValues::PrintValues(const std::string& basename, std::size_t maxPrints, int pLevel)
       : pLevel_(pLevel), currentPrints_(0), maxPrints_(maxPrints), base_(basename),
-        on_(true), doReset_(false), useStdout_(basename.empty()), fptr_(0) {
+        on_(true), doReset_(false), useStdout_(basename.empty()), fptr_(0),
+        binBase_(1), bin_(1), inBin_(0), agg_(MEAN), binPerLevel_(false), binVal_(0), emit_(0),
+        pyramid_(0), track_(0) {
 
     Ext::Assert<Ext::LogicError>(!useStdout_ || pLevel_ >= 0,
                                  "Cannot send each level's information to stdout",
                                  "Logic Error: PrintValues constructor");
   }
 
-  void PrintValues::Level(int level) {
+  PrintValues::PrintValues(const PrintValues& other)
+      : pLevel_(other.pLevel_), currentPrints_(other.currentPrints_), maxPrints_(other.maxPrints_),
+        base_(other.base_), on_(other.on_), doReset_(other.doReset_), useStdout_(other.useStdout_),
+        fptr_(0), binBase_(other.binBase_), bin_(other.bin_), inBin_(0), agg_(other.agg_),
+        binPerLevel_(other.binPerLevel_), binVal_(0), emit_(0), pyramid_(other.pyramid_),
+        track_(0)
+    { /* */ }
+
+  PrintValues& PrintValues::operator=(const PrintValues& other) {
+    if ( this != &other ) {
+      closeFile();
+      pLevel_ = other.pLevel_;
+      currentPrints_ = other.currentPrints_;
+      maxPrints_ = other.maxPrints_;
+      base_ = other.base_;
+      on_ = other.on_;
+      doReset_ = other.doReset_;
+      useStdout_ = other.useStdout_;
+      binBase_ = other.binBase_;
+      bin_ = other.bin_;
+      agg_ = other.agg_;
+      binPerLevel_ = other.binPerLevel_;
+      pyramid_ = other.pyramid_;
+    }
+    return(*this);
+  }
+
+  void PrintValues::Bin(std::size_t size, Aggregate how, bool perLevel) {
+    Ext::Assert<Ext::ArgumentError>(size > 0, "PrintValues::Bin()", "bin size must be > 0");
+    binBase_ = bin_ = size;
+    agg_ = how;
+    binPerLevel_ = perLevel;
+  }
+
+  void PrintValues::Index(PyramidIndex* pyramid)
+    { pyramid_ = pyramid; }
+
+  void PrintValues::startBins(int level) {
+    inBin_ = 0;
+    bin_ = binBase_;
+    if ( binPerLevel_ ) { // size * 2^level, saturating
+      for ( int j = 0; j < level && bin_ < std::numeric_limits<std::size_t>::max() / 2; ++j )
+        bin_ *= 2;
+    }
+  }
+
+  void PrintValues::flushBin() {
+    if ( inBin_ == 0 )
+      return;
+    emit_(*writer_, (agg_ == MEAN) ? binVal_ / inBin_ : binVal_);
+    inBin_ = 0;
+  }
+
+  template <typename T>
+  void PrintValues::emitAs(BlockWriter& w, double v)
+    { w.Put(static_cast<T>(v)); }
+
+  template <typename T>
+  inline void PrintValues::bin(T t) {
+    const double v = static_cast<double>(t);
+    if ( inBin_ == 0 )
+      binVal_ = v, emit_ = &PrintValues::emitAs<T>;
+    else if ( agg_ == MEAN )
+      binVal_ += v;
+    else if ( agg_ == MIN )
+      binVal_ = std::min(binVal_, v);
+    else if ( agg_ == MAX )
+      binVal_ = std::max(binVal_, v);
+    if ( ++inBin_ == bin_ )
+      flushBin();
+  }
+
+  void PrintValues::closeFile() {
+    // the writer thread closes the file once all prior output is written
+    const bool open = (fptr_ != 0);
+    if ( open )
+      flushBin(); // a partial bin at the end of a level
     if ( !useStdout_ && fptr_ )
-      std::fclose(fptr_);
+      writer_->Close(fptr_);
+    if ( !useStdout_ )
+      fptr_ = 0;
+    if ( open && pyramid_ ) // last: the file is handed off even if this throws
+      pyramid_->End(track_);
+  }
+
+  void PrintValues::Close()
+    { closeFile(); }
+
+  void PrintValues::Level(int level) {
+    closeFile();
 
     if ( pLevel_ >= 0 && level != pLevel_ ) {
       on_ = false;
-      if ( !useStdout_ )
-        fptr_ = 0;
       return;
     }
     else if ( !on_ && pLevel_ < 0 ) // manually turned Off()
@@ -72,16 +172,26 @@ namespace WT {
 
     currentPrints_ = 0;
     on_ = true;
+    startBins(level);
+    std::stringstream s;
+    s << level;
+    openFile(base_ + "." + s.str());
+  }
+
+  void PrintValues::openFile(const std::string& name) {
+    if ( !writer_ ) // first, so a failed writer never leaves a file open
+      writer_.reset(new BlockWriter);
     if ( !useStdout_ ) {
-      std::stringstream s;
-      s << level;
-      std::string name = base_ + "." + s.str();
       fptr_ = std::fopen(name.c_str(), "w");
       Ext::Assert<Ext::InvalidFile>(fptr_ && fptr_ != NULL,
                                     "Unable to open file for writing: " + name);
     }
     else
       fptr_ = stdout;
+
+    if ( pyramid_ )
+      track_ = pyramid_->Begin(name);
+    writer_->Open(fptr_);
   }
 
   void PrintValues::Off()
@@ -95,24 +205,29 @@ namespace WT {
 
   void PrintValues::Reset() {
     on_ = true;
-    if ( !useStdout_ ) {
-      if ( fptr_ )
-        std::fclose(fptr_);
-      fptr_ = 0;
-    }
+    closeFile();
   }
 
   template <typename T>
   inline void PrintValues::operator()(T t) {
     if ( on_ ) {
-      if ( ++currentPrints_ <= maxPrints_ )
-        PrintTypes::Println(fptr_, t);
+      if ( ++currentPrints_ <= maxPrints_ ) {
+        if ( pyramid_ )
+          pyramid_->Add(track_, static_cast<double>(t));
+        if ( bin_ <= 1 )
+          writer_->Put(t);
+        else
+          bin(t);
+      }
     }
   }
 
   PrintValues::~PrintValues() {
-    if ( !useStdout_ && fptr_ )
-      std::fclose(fptr_);
+    try {
+      closeFile();
+    } catch(...) { /* never throw from a destructor ; Close() reports errors */ }
+    if ( useStdout_ && writer_ )
+      writer_->Close(stdout); // flushes
   }
 
 
@@ -139,6 +254,385 @@ namespace WT {
   }
 
 
+  //============
+  // PrintNodes
+  //============
+
+  PrintNodes::PrintNodes(const std::string& basename, std::size_t maxPrints)
+      : PrintValues(basename, maxPrints) {
+    Ext::Assert<Ext::LogicError>(!basename.empty(),
+                                 "Cannot use a PrintNodes object with stdout",
+                                 "PrintNodes constructor");
+  }
+
+  void PrintNodes::Node(int level, int index) {
+    closeFile();
+    currentPrints_ = 0;
+    on_ = true;
+    std::stringstream s;
+    s << level << "." << index;
+    startBins(level);
+    openFile(base_ + "." + s.str());
+  }
+
+
+  //===============
+  // PrintWindowed
+  //===============
+
+  PrintWindowed::PrintWindowed(const std::string& basename, std::size_t window, std::size_t step,
+                               std::size_t maxCount, int pLevel)
+      : PrintValues(basename, std::numeric_limits<std::size_t>::max(), pLevel), window_(window),
+        step_(step), maxCount_(maxCount), seen_(0), sum_(0), ring_(window, 0) {
+    Ext::Assert<Ext::ArgumentError>(window > 0 && step > 0, "PrintWindowed", "window and step must be > 0");
+  }
+
+  void PrintWindowed::Level(int level) {
+    PrintValues::Level(level);
+    seen_ = 0, sum_ = 0;
+    std::fill(ring_.begin(), ring_.end(), 0.0);
+  }
+
+  template <typename T>
+  inline void PrintWindowed::operator()(T t) {
+    if ( !on_ || seen_ >= maxCount_ )
+      return;
+    const double sq = static_cast<double>(t) * static_cast<double>(t);
+    double& slot = ring_[seen_ % window_];
+    sum_ += sq - slot;
+    slot = sq;
+    if ( ++seen_ % window_ == 0 ) // resum once per lap ; no drift, O(1) amortized
+      sum_ = std::accumulate(ring_.begin(), ring_.end(), 0.0);
+    if ( seen_ % step_ == 0 )
+      PrintValues::operator()(sum_ / std::min(seen_, window_));
+  }
+
+
+  //==============
+  // PrintColumns
+  //==============
+
+  PrintColumns::PrintColumns(const std::string& basename, std::size_t numSeries, std::size_t maxRows, int pLevel)
+      : base_(basename), maxPrints_(std::numeric_limits<std::size_t>::max()), prints_(0),
+        pLevel_(pLevel), level_(-1), fptr_(0) {
+    Ext::Assert<Ext::ArgumentError>(numSeries > 0 && !basename.empty(), "PrintColumns", "need series and a file name");
+    if ( maxRows < std::numeric_limits<std::size_t>::max() / numSeries )
+      maxPrints_ = maxRows * numSeries;
+    for ( std::size_t s = 0; s < numSeries; ++s )
+      columns_.push_back(Column(this));
+  }
+
+  void PrintColumns::level(int level) {
+    if ( level == level_ ) // every column announces the same level
+      return;
+    Close();
+    level_ = level;
+    if ( pLevel_ >= 0 && level != pLevel_ )
+      return;
+
+    if ( !writer_ )
+      writer_.reset(new BlockWriter(8192, 8, columns_.size()));
+    std::stringstream s;
+    s << base_ << "." << level;
+    fptr_ = std::fopen(s.str().c_str(), "w");
+    Ext::Assert<Ext::InvalidFile>(fptr_ != 0, "Unable to open file for writing: " + s.str());
+    writer_->Open(fptr_);
+    prints_ = 0;
+  }
+
+  template <typename T>
+  inline void PrintColumns::put(T t) {
+    if ( fptr_ && ++prints_ <= maxPrints_ )
+      writer_->Put(t);
+  }
+
+  void PrintColumns::Close() {
+    // the writer thread closes the file once all prior output is written
+    if ( fptr_ )
+      writer_->Close(fptr_);
+    fptr_ = 0;
+  }
+
+  PrintColumns::~PrintColumns()
+    { Close(); }
+
+
+  //=================
+  // ContainerHeader
+  //=================
+
+  ContainerHeader ContainerHeader::Make(std::size_t length, int levels, const std::string& filter,
+                                        std::size_t valueBytes) {
+    ContainerHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic_, "MODWTCF1", sizeof(h.magic_));
+    h.order_ = 0x01020304;
+    h.valueBytes_ = static_cast<std::uint32_t>(valueBytes);
+    h.length_ = static_cast<std::uint64_t>(length);
+    h.levels_ = static_cast<std::uint32_t>(levels);
+    for ( std::size_t i = 0; i < filter.size() && i + 1 < sizeof(h.filter_); ++i )
+      h.filter_[i] = static_cast<char>(std::tolower(filter[i]));
+    return(h);
+  }
+
+  bool ContainerHeader::HasMagic(const char* bytes, std::size_t size)
+    { return(size >= sizeof(ContainerHeader) && 0 == std::memcmp(bytes, "MODWTCF1", 8)); }
+
+  std::string ContainerHeader::Filter() const
+    { return(std::string(filter_, ::strnlen(filter_, sizeof(filter_)))); }
+
+
+  //================
+  // PrintContainer
+  //================
+
+  template <typename T>
+  PrintContainer<T>::PrintContainer(const std::string& name, std::size_t length, int levels,
+                                    const std::string& filter)
+      : name_(name), length_(length), levels_(levels), fd_(-1), filled_(levels + 1, 0),
+        scaling_(this, true), wavelet_(this, false) {
+    static_assert(sizeof(ContainerHeader) == 64, "ContainerHeader must be 64 bytes");
+    Ext::Assert<Ext::ArgumentError>(!name.empty() && length > 0 && levels > 0, "PrintContainer",
+                                    "need a file name, values and levels");
+    fd_ = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    Ext::Assert<Ext::InvalidFile>(fd_ >= 0, "Unable to open file for writing: " + name);
+    const ContainerHeader h = ContainerHeader::Make(length, levels, filter, sizeof(T));
+    write(&h, sizeof(h), 0);
+  }
+
+  template <typename T>
+  void PrintContainer<T>::level(Stream& s, int level) {
+    flush(s);
+    if ( s.scaling_ )
+      s.block_ = (level == levels_) ? 0 : -1;
+    else
+      s.block_ = (level >= 1 && level <= levels_) ? level : -1;
+    s.count_ = 0;
+  }
+
+  template <typename T>
+  inline void PrintContainer<T>::put(Stream& s, const T& t) {
+    if ( s.block_ < 0 || s.count_ >= length_ )
+      return;
+    s.buffer_.push_back(t);
+    ++s.count_;
+    if ( s.buffer_.size() == 16384 )
+      flush(s);
+  }
+
+  template <typename T>
+  void PrintContainer<T>::flush(Stream& s) {
+    if ( s.buffer_.empty() )
+      return;
+    const std::uint64_t at = static_cast<std::uint64_t>(s.block_) * length_ + (s.count_ - s.buffer_.size());
+    write(s.buffer_.data(), s.buffer_.size() * sizeof(T), sizeof(ContainerHeader) + at * sizeof(T));
+    filled_[s.block_] += s.buffer_.size();
+    s.buffer_.clear();
+  }
+
+  template <typename T>
+  void PrintContainer<T>::write(const void* bytes, std::size_t size, std::uint64_t offset) {
+    const char* b = static_cast<const char*>(bytes);
+    while ( size > 0 ) {
+      const ssize_t n = ::pwrite(fd_, b, size, static_cast<off_t>(offset));
+      if ( n < 0 && errno == EINTR )
+        continue;
+      Ext::Assert<Ext::InvalidFile>(n > 0, "Unable to write file: " + name_, std::strerror(errno));
+      b += n, size -= static_cast<std::size_t>(n), offset += static_cast<std::uint64_t>(n);
+    } // while
+  }
+
+  template <typename T>
+  void PrintContainer<T>::Close() {
+    if ( fd_ < 0 )
+      return;
+    const int fd = fd_;
+    try {
+      flush(scaling_);
+      flush(wavelet_);
+    } catch(...) {
+      ::close(fd);
+      fd_ = -1;
+      throw;
+    }
+    fd_ = -1;
+    const bool closed = (0 == ::close(fd));
+    Ext::Assert<Ext::InvalidFile>(closed, "Unable to write file: " + name_, closed ? "" : std::strerror(errno));
+    for ( std::size_t b = 0; b < filled_.size(); ++b )
+      Ext::Assert<Ext::ProgramError>(filled_[b] == length_, "PrintContainer", "a block was left short: " + name_);
+  }
+
+  template <typename T>
+  PrintContainer<T>::~PrintContainer() {
+    try {
+      Close();
+    } catch(...) { /* Close() reports failures to callers that ask */ }
+  }
+
+
+  //===========
+  // PrintRuns
+  //===========
+
+  PrintRuns::PrintRuns(const std::string& basename, std::size_t limit, int pLevel)
+      : base_(basename), limit_(limit), pLevel_(pLevel), fptr_(0)
+    { /* */ }
+
+  void PrintRuns::closeFile() {
+    if ( fptr_ && fptr_ != stdout )
+      std::fclose(fptr_);
+    else if ( fptr_ )
+      std::fflush(stdout);
+    fptr_ = 0;
+  }
+
+  void PrintRuns::Level(int level) {
+    closeFile();
+    if ( pLevel_ >= 0 && level != pLevel_ )
+      return;
+    if ( base_.empty() ) {
+      fptr_ = stdout;
+      return;
+    }
+    std::stringstream s;
+    s << base_ << "." << level;
+    fptr_ = std::fopen(s.str().c_str(), "w");
+    Ext::Assert<Ext::InvalidFile>(fptr_ != 0, "Unable to open file for writing: " + s.str());
+  }
+
+  template <typename T>
+  inline void PrintRuns::operator()(std::size_t start, std::size_t length, const T& t) {
+    if ( !fptr_ || start >= limit_ )
+      return;
+    const std::size_t end = std::min(start + length, limit_);
+    std::fprintf(fptr_, "%lu\t%lu\t", static_cast<unsigned long>(start), static_cast<unsigned long>(end));
+    PrintTypes::Println(fptr_, t);
+  }
+
+  PrintRuns::~PrintRuns()
+    { closeFile(); }
+
+
+  //=============
+  // DetectPeaks
+  //=============
+
+  DetectPeaks::DetectPeaks(double high, double low, int pLevel, bool minima, std::size_t maxCount)
+      : high_(high), low_(low), pLevel_(pLevel), current_(0), on_(false), minima_(minima),
+        maxCount_(maxCount), seen_(0), state_(0), bestPos_(0), best_(0), nextLine_(0) {
+    Ext::Assert<Ext::ArgumentError>(high > 0 && low >= 0 && low <= high, "DetectPeaks",
+                                    "need high > 0 and 0 <= low <= high");
+  }
+
+  void DetectPeaks::Level(int level) {
+    finish();
+    on_ = (pLevel_ >= 0 && level == pLevel_);
+    if ( on_ )
+      current_ = level, seen_ = 0, state_ = 0;
+  }
+
+  void DetectPeaks::Off()
+    { on_ = false; }
+
+  void DetectPeaks::On()
+    { on_ = true; }
+
+  bool DetectPeaks::IsOn() const
+    { return(on_); }
+
+  void DetectPeaks::Reset() {
+    finish();
+    if ( pLevel_ >= 0 )
+      ++pLevel_;
+  }
+
+  const std::vector<DetectPeaks::Event>& DetectPeaks::Events() {
+    finish();
+    return(events_);
+  }
+
+  void DetectPeaks::close() {
+    Event e;
+    e.level_ = current_;
+    e.position_ = bestPos_;
+    e.amplitude_ = best_;
+    e.line_ = -1;
+    this_.push_back(e);
+    state_ = 0;
+  }
+
+  void DetectPeaks::finish() {
+    if ( current_ <= 0 || seen_ == 0 ) // doAll() calls Level() once before the cascade does
+      return;
+    if ( state_ != 0 )
+      close();
+
+    // link to the level below ; both lists are in position order
+    const double reach = std::pow(2.0, current_);
+    std::vector<bool> used(prev_.size(), false);
+    for ( std::size_t i = 0; i < this_.size(); ++i ) {
+      Event& e = this_[i];
+      std::size_t lo = 0, hi = prev_.size();
+      while ( lo < hi ) { // first of prev_ at or beyond e
+        std::size_t mid = (lo + hi) / 2;
+        if ( prev_[mid].position_ < e.position_ )
+          lo = mid + 1;
+        else
+          hi = mid;
+      } // while
+
+      // nearest unused extremum of the same sign within reach, either side
+      std::size_t best = prev_.size();
+      double bestDist = reach;
+      for ( int dir = -1; dir <= 1; dir += 2 ) {
+        for ( std::size_t k = (dir < 0) ? lo - 1 : lo; k < prev_.size(); k += dir ) { // k wraps past 0
+          const double dist = std::fabs(static_cast<double>(prev_[k].position_) - static_cast<double>(e.position_));
+          if ( dist > bestDist )
+            break;
+          if ( !used[k] && (prev_[k].amplitude_ > 0) == (e.amplitude_ > 0) )
+            best = k, bestDist = dist;
+        } // for
+      } // for
+      if ( best < prev_.size() )
+        used[best] = true, e.line_ = prev_[best].line_;
+      else
+        e.line_ = nextLine_++;
+    } // for
+
+    events_.insert(events_.end(), this_.begin(), this_.end());
+    prev_.swap(this_);
+    this_.clear();
+    current_ = 0;
+  }
+
+  template <typename T>
+  inline void DetectPeaks::operator()(const T& t) {
+    if ( !on_ || seen_ >= maxCount_ )
+      return;
+    const double v = static_cast<double>(t);
+    const std::size_t pos = seen_++;
+    if ( state_ > 0 ) {
+      if ( v > best_ )
+        best_ = v, bestPos_ = pos;
+      else if ( v < low_ )
+        close();
+    }
+    else if ( state_ < 0 ) {
+      if ( v < best_ )
+        best_ = v, bestPos_ = pos;
+      else if ( v > -low_ )
+        close();
+    }
+
+    if ( state_ == 0 ) {
+      if ( v >= high_ )
+        state_ = 1, best_ = v, bestPos_ = pos;
+      else if ( minima_ && v <= -high_ )
+        state_ = -1, best_ = v, bestPos_ = pos;
+    }
+  }
+
+
   //===============
   // SaveAllValues
   //===============
@@ -227,4 +721,280 @@ namespace WT {
       vals_.push_back(t);
   }
 
+
+  //=================
+  // WaveletVariance
+  //=================
+
+  namespace Details {
+    // Acklam's rational approximation to the inverse of the standard normal cdf
+    inline double normalQuantile(double p) {
+      static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                   1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+      static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                   6.680131188771972e+01, -1.328068155288572e+01 };
+      static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                  -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+      static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                  3.754408661907416e+00 };
+      const double lo = 0.02425;
+      if ( p < lo ) {
+        double q = std::sqrt(-2 * std::log(p));
+        return((((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) / ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1));
+      }
+      if ( p > 1 - lo )
+        return(-normalQuantile(1 - p));
+      double q = p - 0.5, r = q * q;
+      return((((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q /
+             (((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1));
+    }
+
+    // Wilson-Hilferty approximation to the p quantile of chi-square with eta degrees of freedom
+    inline double chiSquareQuantile(double eta, double p) {
+      const double h = 2 / (9 * eta);
+      const double w = 1 - h + normalQuantile(p) * std::sqrt(h);
+      return(eta * w * w * w);
+    }
+  } // namespace Details
+
+  WaveletVariance::WaveletVariance(std::size_t filterLength, std::size_t maxCount, double confidence)
+      : on_(true), L_(filterLength), maxCount_(maxCount), skip_(0), seen_(0), conf_(confidence),
+        sum_(0), sumsq_(0), level_(0) {
+    Ext::Assert<Ext::ArgumentError>(filterLength > 1, "WaveletVariance", "bad filter length");
+    Ext::Assert<Ext::ArgumentError>(confidence > 0 && confidence < 1, "WaveletVariance", "bad confidence");
+  }
+
+  void WaveletVariance::Level(int level) {
+    if ( !on_ )
+      return;
+    finish();
+    level_ = level;
+    // L_j - 1 = (2^j - 1)(L - 1) boundary coefficients ; saturate at deep levels
+    const double lj = (std::pow(2.0, level) - 1) * static_cast<double>(L_ - 1);
+    skip_ = (lj >= static_cast<double>(std::numeric_limits<std::size_t>::max()))
+              ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(lj);
+    seen_ = 0, sum_ = 0, sumsq_ = 0;
+  }
+
+  void WaveletVariance::finish() {
+    if ( level_ <= 0 )
+      return;
+    Estimate e;
+    e.level_ = level_;
+    const std::size_t upto = std::min(seen_, maxCount_);
+    e.count_ = (upto > skip_) ? upto - skip_ : 0;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    e.mean_ = e.variance_ = e.lower_ = e.upper_ = e.edof_ = nan;
+    if ( e.count_ > 0 ) {
+      const double M = static_cast<double>(e.count_);
+      e.mean_ = sum_ / M;
+      e.variance_ = sumsq_ / M;
+      e.edof_ = std::max(M / std::pow(2.0, level_), 1.0);
+      const double alpha = 1 - conf_;
+      e.lower_ = e.edof_ * e.variance_ / Details::chiSquareQuantile(e.edof_, 1 - alpha / 2);
+      e.upper_ = e.edof_ * e.variance_ / Details::chiSquareQuantile(e.edof_, alpha / 2);
+    }
+    est_.push_back(e);
+    level_ = 0;
+  }
+
+  void WaveletVariance::Off()
+    { on_ = false; }
+
+  void WaveletVariance::On()
+    { on_ = true; }
+
+  bool WaveletVariance::IsOn() const
+    { return(on_); }
+
+  void WaveletVariance::Reset() {
+    est_.clear();
+    level_ = 0, seen_ = 0, sum_ = 0, sumsq_ = 0;
+    on_ = true;
+  }
+
+  const std::vector<WaveletVariance::Estimate>& WaveletVariance::Estimates() {
+    finish();
+    return(est_);
+  }
+
+  template <typename T>
+  inline void WaveletVariance::operator()(const T& t) {
+    if ( on_ && seen_++ >= skip_ && seen_ <= maxCount_ ) {
+      const double d = static_cast<double>(t);
+      sum_ += d;
+      sumsq_ += d * d;
+    }
+  }
+
+
+  //=========================
+  // WaveletCrossCorrelation
+  //=========================
+
+  WaveletCrossCorrelation::WaveletCrossCorrelation(std::size_t filterLength, std::size_t maxLag,
+                                                   std::size_t maxCount)
+      : on_(true), L_(filterLength), maxLag_(maxLag), maxCount_(maxCount), skip_(0), seen_(0),
+        used_(0), sxx_(0), syy_(0), ringX_(maxLag + 1, 0), ringY_(maxLag + 1, 0),
+        sxy_(2 * maxLag + 1, 0), level_(0) {
+    Ext::Assert<Ext::ArgumentError>(filterLength > 1, "WaveletCrossCorrelation", "bad filter length");
+  }
+
+  void WaveletCrossCorrelation::Level(int level) {
+    if ( !on_ )
+      return;
+    finish();
+    level_ = level;
+    const double lj = (std::pow(2.0, level) - 1) * static_cast<double>(L_ - 1);
+    skip_ = (lj >= static_cast<double>(std::numeric_limits<std::size_t>::max()))
+              ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(lj);
+    seen_ = used_ = 0, sxx_ = syy_ = 0;
+    std::fill(sxy_.begin(), sxy_.end(), 0.0);
+  }
+
+  void WaveletCrossCorrelation::finish() {
+    if ( level_ <= 0 )
+      return;
+    Estimate e;
+    e.level_ = level_;
+    e.count_ = used_;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    e.varianceX_ = e.varianceY_ = nan;
+    e.covariance_.assign(sxy_.size(), nan);
+    e.correlation_.assign(sxy_.size(), nan);
+    if ( used_ > 0 ) {
+      const double M = static_cast<double>(used_);
+      e.varianceX_ = sxx_ / M, e.varianceY_ = syy_ / M;
+      const double denom = std::sqrt(e.varianceX_ * e.varianceY_);
+      for ( std::size_t i = 0; i < sxy_.size(); ++i ) {
+        e.covariance_[i] = sxy_[i] / M;
+        if ( denom > 0 )
+          e.correlation_[i] = e.covariance_[i] / denom;
+      } // for
+    }
+    est_.push_back(e);
+    level_ = 0;
+  }
+
+  void WaveletCrossCorrelation::Off()
+    { on_ = false; }
+
+  void WaveletCrossCorrelation::On()
+    { on_ = true; }
+
+  bool WaveletCrossCorrelation::IsOn() const
+    { return(on_); }
+
+  void WaveletCrossCorrelation::Reset() {
+    est_.clear();
+    level_ = 0, seen_ = used_ = 0, sxx_ = syy_ = 0;
+    on_ = true;
+  }
+
+  std::size_t WaveletCrossCorrelation::MaxLag() const
+    { return(maxLag_); }
+
+  const std::vector<WaveletCrossCorrelation::Estimate>& WaveletCrossCorrelation::Estimates() {
+    finish();
+    return(est_);
+  }
+
+  template <typename T>
+  inline void WaveletCrossCorrelation::operator()(const T& wx, const T& wy) {
+    if ( !on_ || seen_++ < skip_ || seen_ > maxCount_ )
+      return;
+
+    // the k-th usable pair ; ring slots hold pairs k-maxLag..k
+    const std::size_t R = maxLag_ + 1, k = used_++;
+    const double x = static_cast<double>(wx), y = static_cast<double>(wy);
+    ringX_[k % R] = x, ringY_[k % R] = y;
+    sxx_ += x * x, syy_ += y * y;
+    sxy_[maxLag_] += x * y;
+    const std::size_t reach = std::min(maxLag_, k);
+    for ( std::size_t tau = 1; tau <= reach; ++tau ) {
+      const std::size_t slot = (k - tau) % R;
+      sxy_[maxLag_ + tau] += ringX_[slot] * y; // Wx[t-tau] Wy[t]
+      sxy_[maxLag_ - tau] += x * ringY_[slot]; // Wx[t] Wy[t-tau]
+    } // for
+  }
+
+
+  //====================
+  // SparseCoefficients
+  //====================
+
+  template <typename T>
+  SparseCoefficients<T>::SparseCoefficients(std::size_t k, double minMagnitude, bool global,
+                                            std::size_t maxCount, int pLevel)
+      : on_(true), global_(global), k_(k), maxCount_(maxCount), seen_(0), min_(minMagnitude),
+        pLevel_(pLevel), level_(0)
+    { /* */ }
+
+  template <typename T>
+  void SparseCoefficients<T>::Level(int level) {
+    if ( pLevel_ >= 0 )
+      on_ = (level == pLevel_);
+    level_ = level, seen_ = 0;
+    if ( on_ && (heaps_.empty() || !global_) )
+      heaps_.push_back(std::vector<Entry>());
+  }
+
+  template <typename T>
+  void SparseCoefficients<T>::Off()
+    { on_ = false; }
+
+  template <typename T>
+  void SparseCoefficients<T>::On()
+    { on_ = true; }
+
+  template <typename T>
+  bool SparseCoefficients<T>::IsOn() const
+    { return(on_); }
+
+  template <typename T>
+  void SparseCoefficients<T>::Reset() {
+    heaps_.clear();
+    on_ = true;
+  }
+
+  template <typename T>
+  std::vector<typename SparseCoefficients<T>::Entry> SparseCoefficients<T>::Entries() const {
+    std::vector<Entry> all;
+    for ( std::size_t i = 0; i < heaps_.size(); ++i )
+      all.insert(all.end(), heaps_[i].begin(), heaps_[i].end());
+    std::sort(all.begin(), all.end(), before);
+    return(all);
+  }
+
+  template <typename T>
+  bool SparseCoefficients<T>::before(const Entry& a, const Entry& b) // level, then index
+    { return(a.level_ < b.level_ || (a.level_ == b.level_ && a.index_ < b.index_)); }
+
+  template <typename T>
+  bool SparseCoefficients<T>::smaller(const Entry& a, const Entry& b) // heap top is the smallest |value|
+    { return(std::fabs(static_cast<double>(a.value_)) > std::fabs(static_cast<double>(b.value_))); }
+
+  template <typename T>
+  inline void SparseCoefficients<T>::operator()(const T& t) {
+    if ( !on_ || heaps_.empty() || seen_ >= maxCount_ )
+      return;
+    const Entry e = { level_, seen_++, t };
+    const double mag = std::fabs(static_cast<double>(t));
+    if ( !(mag > min_) )
+      return;
+
+    std::vector<Entry>& heap = heaps_.back();
+    if ( k_ == 0 ) // no bound ; nothing is ever evicted
+      heap.push_back(e);
+    else if ( heap.size() < k_ ) {
+      heap.push_back(e);
+      std::push_heap(heap.begin(), heap.end(), smaller);
+    }
+    else if ( mag > std::fabs(static_cast<double>(heap.front().value_)) ) {
+      std::pop_heap(heap.begin(), heap.end(), smaller);
+      heap.back() = e;
+      std::push_heap(heap.begin(), heap.end(), smaller);
+    }
+  }
+
 } // namespace WT
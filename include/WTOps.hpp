@@ -26,11 +26,16 @@
 #define WT_OPS_FRAMEWORK_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "WTPyramid.hpp"
+#include "WTWriter.hpp"
+
 namespace WT {
 
   //=============
@@ -38,6 +43,7 @@ namespace WT {
   //=============
   struct DoNothing {
     void Level(int level) { /* */ }
+    void Node(int level, int index) { /* */ }
     void Off() { /* */ }
     void On() { /* */ }
     bool IsOn() { return(false); }
@@ -45,6 +51,9 @@ namespace WT {
 
     template <typename T>
     inline void operator()(const T& t) { /* */ }
+
+    template <typename T> // a run of equal values ; see WTRuns.hpp
+    inline void operator()(std::size_t start, std::size_t length, const T& t) { /* */ }
   };
 
   //===============
@@ -57,28 +66,73 @@ namespace WT {
     boundary condition for a wavelet option.  The output will have 2*N items
     for an N input items.  The maxPrints parameter allows one to print the first
     N computed values instead.
+    Bin() makes the object write one value per bin of consecutive inputs
+    instead of every input: the first of them (SAMPLE, i.e. every k-th
+    value), or their MEAN, MIN or MAX.  With perLevel, the bin size is
+    size * 2^level, which suits waveforms that get smoother with level.
+    maxPrints still counts inputs, and a partial bin at the end of a level
+    is written as well.
+    Index() also sends every value printed (before any binning) to a
+    PyramidIndex, as a track named after its output file.  The index is
+    shared by copies and must outlive this object.  Close() finishes the
+    current file and lets an error from the index through, which the
+    destructor cannot.
+    Values are formatted and written by a BlockWriter thread owned by this
+    object, so output overlaps with computation.  A copy starts out with no
+    open file and no writer of its own.
   */
   struct PrintValues : public DoNothing {
+    enum Aggregate { SAMPLE, MEAN, MIN, MAX };
+
     explicit PrintValues(const std::string& basename,
                          std::size_t maxPrints = std::numeric_limits<std::size_t>::max(),
                          int pLevel = -1);
+    PrintValues(const PrintValues& other);
+    PrintValues& operator=(const PrintValues& other);
+
+    void Bin(std::size_t size, Aggregate how = MEAN, bool perLevel = false);
+    void Index(PyramidIndex* pyramid);
 
     void Level(int level);
     void Off();
     void On();
     bool IsOn() const;
     void Reset();
+    void Close();
     template <typename T>
     inline void operator()(T t);
     ~PrintValues();
 
+  protected:
+    void closeFile();
+    void openFile(const std::string& name);
+    void startBins(int level);
+
+  private:
+    template <typename T>
+    inline void bin(T t);
+    void flushBin();
+
+    template <typename T>
+    static void emitAs(BlockWriter& w, double v);
+
   protected:
     int pLevel_;
     std::size_t currentPrints_;
     std::size_t maxPrints_;
     std::string base_;
     bool on_, doReset_, useStdout_;
-    FILE* fptr_;    
+    FILE* fptr_;
+    std::unique_ptr<BlockWriter> writer_;
+
+  private:
+    std::size_t binBase_, bin_, inBin_;
+    Aggregate agg_;
+    bool binPerLevel_;
+    double binVal_;
+    void (*emit_)(BlockWriter&, double); // keeps the type of the values binned
+    PyramidIndex* pyramid_;
+    std::size_t track_;
   };
 
 
@@ -107,6 +161,273 @@ namespace WT {
   };
 
 
+  //==============
+  // PrintNodes()
+  //==============
+  /*
+    PrintValues for wavelet packet transforms such as modwpt().  Each call to
+    Node(level, index) starts a new output file named basename.level.index,
+    and all values received until the next Node() call go to that file.
+  */
+  struct PrintNodes : public PrintValues {
+    explicit PrintNodes(const std::string& basename,
+                        std::size_t maxPrints = std::numeric_limits<std::size_t>::max());
+    void Node(int level, int index);
+  };
+
+
+  //=================
+  // PrintWindowed()
+  //=================
+  /*
+    PrintValues for the local energy of a level rather than its values: each
+    output is the mean of the squares of the most recent 'window' inputs
+    (fewer at the very start of a level).  One value is written for every
+    'step' inputs, so step == 1 gives full resolution and step == window
+    gives non-overlapping windows.  A ring of 'window' values is all that is
+    kept per level.  Inputs beyond maxCount are ignored, as with the
+    maxPrints argument to PrintValues.
+  */
+  struct PrintWindowed : public PrintValues {
+    PrintWindowed(const std::string& basename, std::size_t window, std::size_t step = 1,
+                  std::size_t maxCount = std::numeric_limits<std::size_t>::max(), int pLevel = -1);
+
+    void Level(int level);
+    template <typename T>
+    inline void operator()(T t);
+
+  private:
+    std::size_t window_, step_, maxCount_, seen_;
+    double sum_;
+    std::vector<double> ring_;
+  };
+
+
+  //================
+  // PrintColumns()
+  //================
+  /*
+    Output ops for modwt_multi(), which transforms many series together: the
+    values of every series at one position make one line of the file
+    basename.level, a column per series, in place of a file per series.
+    One writer thread serves all of the columns.  operator[](s) is the op
+    for series s, so a PrintColumns stands in for the container of ops.
+    This relies on modwt_multi() giving, at each position, one value to
+    every series in turn.  maxRows and pLevel act as maxPrints and pLevel
+    do for PrintValues.
+  */
+  struct PrintColumns {
+    struct Column : public DoNothing {
+      Column(PrintColumns* all) : all_(all)
+        { /* */ }
+      void Level(int level)
+        { all_->level(level); }
+      template <typename T>
+      inline void operator()(T t)
+        { all_->put(t); }
+    private:
+      PrintColumns* all_;
+    };
+
+    PrintColumns(const std::string& basename, std::size_t numSeries,
+                 std::size_t maxRows = std::numeric_limits<std::size_t>::max(), int pLevel = -1);
+
+    std::size_t size() const
+      { return(columns_.size()); }
+    Column& operator[](std::size_t s)
+      { return(columns_[s]); }
+    void Close();
+    ~PrintColumns();
+
+  private:
+    PrintColumns(const PrintColumns&); // not copyable ; Columns point here
+    PrintColumns& operator=(const PrintColumns&);
+
+    void level(int level);
+    template <typename T>
+    inline void put(T t);
+
+  private:
+    std::string base_;
+    std::size_t maxPrints_, prints_;
+    int pLevel_, level_;
+    FILE* fptr_;
+    std::unique_ptr<BlockWriter> writer_;
+    std::vector<Column> columns_;
+  };
+
+
+  //===================
+  // ContainerHeader()
+  //===================
+  /*
+    The first 64 bytes of a file written by PrintContainer.  'order_' reads
+    back as 0x01020304 only on a machine of the writer's byte order, and
+    'valueBytes_' is sizeof the value type, so a reader can refuse a file it
+    would misread.  Blocks of length_ values follow: V_J, then W_1..W_J.
+  */
+  struct ContainerHeader {
+    char magic_[8];
+    std::uint32_t order_;
+    std::uint32_t valueBytes_;
+    std::uint64_t length_;
+    std::uint32_t levels_;
+    char filter_[16]; // lower case, 0-padded
+    char unused_[20];
+
+    static ContainerHeader Make(std::size_t length, int levels, const std::string& filter, std::size_t valueBytes);
+    static bool HasMagic(const char* bytes, std::size_t size);
+    std::string Filter() const;
+  };
+
+
+  //==================
+  // PrintContainer()
+  //==================
+  /*
+    Output ops for modwt() that put all of a transform's coefficients in one
+    binary file, in place of the scaling-coefficients.J and
+    wavelet-coefficients.1..J files of --binary output: a ContainerHeader,
+    V_J, then W_1..W_J, each 'length' native T's.  Scaling() is the vop,
+    and it ignores levels other than 'levels' ; Wavelet() is the wop.  Each
+    keeps its own buffer and file position, so values may come to the two
+    in any interleaving.  Close() reports a write that failed or a block
+    left short ; the destructor cannot, so call Close().
+  */
+  template <typename T>
+  struct PrintContainer {
+    struct Stream : public DoNothing {
+      Stream(PrintContainer* all, bool scaling) : all_(all), scaling_(scaling), block_(-1), count_(0)
+        { /* */ }
+      void Level(int level)
+        { all_->level(*this, level); }
+      inline void operator()(const T& t)
+        { all_->put(*this, t); }
+    private:
+      friend struct PrintContainer;
+      PrintContainer* all_;
+      bool scaling_;
+      int block_; // 0 is V_J, j is W_j, < 0 is off
+      std::size_t count_;
+      std::vector<T> buffer_;
+    };
+
+    PrintContainer(const std::string& name, std::size_t length, int levels, const std::string& filter);
+
+    Stream& Scaling()
+      { return(scaling_); }
+    Stream& Wavelet()
+      { return(wavelet_); }
+    void Close();
+    ~PrintContainer();
+
+  private:
+    PrintContainer(const PrintContainer&); // not copyable ; Streams point here
+    PrintContainer& operator=(const PrintContainer&);
+
+    void level(Stream& s, int level);
+    inline void put(Stream& s, const T& t);
+    void flush(Stream& s);
+    void write(const void* bytes, std::size_t size, std::uint64_t offset);
+
+  private:
+    std::string name_;
+    std::size_t length_;
+    int levels_, fd_;
+    std::vector<std::size_t> filled_; // values written, per block
+    Stream scaling_, wavelet_;
+  };
+
+
+  //=============
+  // PrintRuns()
+  //=============
+  /*
+    Output op for the run-length functions of WTRuns.hpp: each run is one
+    line of 'start end value', with 'end' exclusive.  Level() starts the file
+    basename.level, or writes to stdout when basename is empty.  With
+    pLevel >= 0, only that level is written.  Runs are clipped to positions
+    before 'limit', as maxPrints does for PrintValues.
+  */
+  struct PrintRuns : public DoNothing {
+    explicit PrintRuns(const std::string& basename,
+                       std::size_t limit = std::numeric_limits<std::size_t>::max(),
+                       int pLevel = -1);
+
+    void Level(int level);
+    template <typename T>
+    inline void operator()(std::size_t start, std::size_t length, const T& t);
+    ~PrintRuns();
+
+  private:
+    PrintRuns(const PrintRuns&); // not copyable
+    PrintRuns& operator=(const PrintRuns&);
+
+    void closeFile();
+
+  private:
+    std::string base_;
+    std::size_t limit_;
+    int pLevel_;
+    FILE* fptr_;
+  };
+
+
+  //===============
+  // DetectPeaks()
+  //===============
+  /*
+    Finds extrema in a waveform as it streams by, rather than storing it.
+    A maximum starts when a value reaches 'high' and ends when values fall
+    below 'low' (hysteresis), and the largest value in between is reported;
+    with 'minima' the same holds for values at or below -high.
+    Like PrintLast, only the values given after Level(pLevel) are looked at,
+    and Reset() moves pLevel up by one.  That makes a DetectPeaks object a
+    details op for doAll() and mra(), where each level's detail waveform
+    comes out at the last step of its own cascade.  Used as the smooth op,
+    pLevel is simply the last level.
+    When a level ends, each of its extrema is linked to the nearest unused
+    extremum of the same sign from the level before, if any lies within
+    2^level positions, so that chains of linked extrema form maxima lines
+    across scales.  Events() lists everything found, one level after another.
+  */
+  struct DetectPeaks : public DoNothing {
+    struct Event {
+      int level_;
+      std::size_t position_;
+      double amplitude_;
+      long line_; // extrema sharing a line_ are linked across levels
+    };
+
+    DetectPeaks(double high, double low, int pLevel, bool minima = true,
+                std::size_t maxCount = std::numeric_limits<std::size_t>::max());
+    void Level(int level);
+    void Off();
+    void On();
+    bool IsOn() const;
+    void Reset();
+    const std::vector<Event>& Events(); // finishes the last level
+
+    template <typename T>
+    inline void operator()(const T& t);
+
+  private:
+    void close();
+    void finish();
+
+  private:
+    double high_, low_;
+    int pLevel_, current_;
+    bool on_, minima_;
+    std::size_t maxCount_, seen_;
+    int state_; // 0, or the sign of the extremum being followed
+    std::size_t bestPos_;
+    double best_;
+    long nextLine_;
+    std::vector<Event> events_, this_, prev_;
+  };
+
+
   //=================
   // SaveAllValues()
   //=================
@@ -179,6 +500,150 @@ namespace WT {
     std::vector<T> vals_;
   };
 
+  //===================
+  // WaveletVariance()
+  //===================
+  /*
+    Reduces the wavelet coefficients of each level, as modwt() emits them,
+    to an estimate of the wavelet variance without storing any coefficient.
+    The first L_j - 1 coefficients of level j, L_j = (2^j - 1)(L - 1) + 1,
+    wrap around the periodic boundary and are excluded, as are any beyond
+    maxCount (the doubled half of a reflected series).  From the remaining
+    M_j coefficients we report the unbiased estimator of Percival & Walden
+    (section 8.3), the mean of their squares, along with a confidence
+    interval based on the equivalent degrees of freedom
+    eta = max(M_j / 2^j, 1) and chi-square quantiles (Wilson-Hilferty).
+    A level with no coefficients clear of the boundary has a count of 0
+    and NaN estimates.
+  */
+  struct WaveletVariance : public DoNothing {
+    struct Estimate {
+      int level_;
+      std::size_t count_; // M_j
+      double mean_, variance_, lower_, upper_, edof_;
+    };
+
+    explicit WaveletVariance(std::size_t filterLength,
+                             std::size_t maxCount = std::numeric_limits<std::size_t>::max(),
+                             double confidence = 0.95);
+    void Level(int level);
+    void Off();
+    void On();
+    bool IsOn() const;
+    void Reset();
+    const std::vector<Estimate>& Estimates(); // finishes the last level
+
+    template <typename T>
+    inline void operator()(const T& t);
+
+  private:
+    void finish();
+
+  private:
+    bool on_;
+    std::size_t L_, maxCount_, skip_, seen_;
+    double conf_, sum_, sumsq_;
+    int level_;
+    std::vector<Estimate> est_;
+  };
+
+  //===========================
+  // WaveletCrossCorrelation()
+  //===========================
+  /*
+    A paired op: operator()(wx, wy) takes the level j wavelet coefficients
+    of two series at the same time point, as modwt_pair() and
+    ReferenceSeries emit them.  Like WaveletVariance, the L_j - 1
+    boundary coefficients and any beyond maxCount are excluded.  For lags
+    tau = -maxLag..maxLag the cross-covariance estimate (Percival & Walden
+    section 8.8) is
+        cov_tau = (1/M_j) sum_t Wx[t] Wy[t+tau]
+    over the M_j usable coefficients, and the cross-correlation is cov_tau
+    divided by the square root of the two wavelet variances.  The last
+    maxLag values of each series are kept in a ring, so nothing else is
+    stored.
+  */
+  struct WaveletCrossCorrelation : public DoNothing {
+    struct Estimate {
+      int level_;
+      std::size_t count_; // M_j
+      double varianceX_, varianceY_;
+      std::vector<double> covariance_, correlation_; // index = lag + maxLag
+    };
+
+    WaveletCrossCorrelation(std::size_t filterLength, std::size_t maxLag = 0,
+                            std::size_t maxCount = std::numeric_limits<std::size_t>::max());
+    void Level(int level);
+    void Off();
+    void On();
+    bool IsOn() const;
+    void Reset();
+    std::size_t MaxLag() const;
+    const std::vector<Estimate>& Estimates(); // finishes the last level
+
+    template <typename T>
+    inline void operator()(const T& wx, const T& wy);
+
+  private:
+    void finish();
+
+  private:
+    bool on_;
+    std::size_t L_, maxLag_, maxCount_, skip_, seen_, used_;
+    double sxx_, syy_;
+    std::vector<double> ringX_, ringY_, sxy_; // sxy_ index = lag + maxLag
+    int level_;
+    std::vector<Estimate> est_;
+  };
+
+  //======================
+  // SparseCoefficients()
+  //======================
+  /*
+    Keeps only the largest-magnitude values it is given, as (level, index,
+    value) entries: the k largest of each level or, with 'global', the k
+    largest over all levels, and of those only the ones with |value| above
+    minMagnitude.  k == 0 puts no bound on the count, leaving minMagnitude
+    alone to decide ; with a negative minMagnitude as well, every value is
+    kept.  A bounded min-heap on |value| holds the candidates,
+    so memory is O(k) however many values stream through.  As with
+    PrintValues, a pLevel >= 0 limits the object to that one level, and
+    values beyond maxCount in a level are ignored.  Entries() gives what
+    was kept, ordered by level and then index ; see imodwt_sparse().
+  */
+  template <typename T>
+  struct SparseCoefficients : public DoNothing {
+    struct Entry {
+      typedef T value_type;
+      int level_;
+      std::size_t index_;
+      T value_;
+    };
+
+    explicit SparseCoefficients(std::size_t k, double minMagnitude = 0, bool global = false,
+                                std::size_t maxCount = std::numeric_limits<std::size_t>::max(),
+                                int pLevel = -1);
+    void Level(int level);
+    void Off();
+    void On();
+    bool IsOn() const;
+    void Reset();
+    std::vector<Entry> Entries() const;
+
+    inline void operator()(const T& t);
+
+  private:
+    static bool smaller(const Entry& a, const Entry& b);
+    static bool before(const Entry& a, const Entry& b);
+
+  private:
+    bool on_, global_;
+    std::size_t k_, maxCount_, seen_;
+    double min_;
+    int pLevel_, level_;
+    std::vector< std::vector<Entry> > heaps_; // one per level ; only [0] with global_
+  };
+
 } // namespace WT
 
 #include "WTOps.cpp"
@@ -0,0 +1,342 @@
+/*
+  FILE: WTOutput.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 11:02:17 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef WT_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTOutput.hpp"
+
+
+namespace WT {
+
+  //=================
+  // writerOptions()
+  //=================
+  WriterOptions& writerOptions() {
+    static WriterOptions opts;
+    return(opts);
+  }
+
+
+  //==============
+  // WriteBackend
+  //==============
+
+  void WriteBackend::writeAll(int fd, const char* buf, std::size_t len, long long offset) {
+    // offset < 0 -> sequential write() at the current file position
+    while ( len > 0 ) {
+      ssize_t w = (offset < 0) ? ::write(fd, buf, len) : ::pwrite(fd, buf, len, static_cast<off_t>(offset));
+      if ( w < 0 ) {
+        if ( errno == EINTR || errno == EAGAIN )
+          continue;
+        return; // like stdio, we do not report write failures from here
+      }
+      buf += w;
+      len -= static_cast<std::size_t>(w);
+      if ( offset >= 0 )
+        offset += w;
+    } // while
+  }
+
+
+  //===============
+  // PWriteBackend
+  //===============
+
+  PWriteBackend::PWriteBackend(std::size_t queueDepth, std::size_t bufferBytes, std::size_t numThreads)
+      : WriteBackend(bufferBytes), bufs_(queueDepth, std::vector<char>(bufferBytes)),
+        outstanding_(0), stop_(false) {
+
+    for ( std::size_t i = 0; i < queueDepth; ++i )
+      free_.push_back(i);
+    for ( std::size_t i = 0; i < numThreads; ++i )
+      threads_.push_back(std::thread(&PWriteBackend::run, this));
+  }
+
+  char* PWriteBackend::Acquire(std::size_t& id) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while ( free_.empty() )
+      done_.wait(lock);
+    id = free_.back();
+    free_.pop_back();
+    return(&bufs_[id][0]);
+  }
+
+  void PWriteBackend::Write(int fd, std::size_t id, std::size_t len, long long offset) {
+    Job j = { fd, id, len, offset };
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      jobs_.push_back(j);
+      ++outstanding_;
+    }
+    work_.notify_one();
+  }
+
+  void PWriteBackend::Drain() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while ( outstanding_ > 0 )
+      done_.wait(lock);
+  }
+
+  void PWriteBackend::run() {
+    while ( true ) {
+      Job j;
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while ( jobs_.empty() && !stop_ )
+          work_.wait(lock);
+        if ( jobs_.empty() ) // stop_
+          return;
+        j = jobs_.front();
+        jobs_.pop_front();
+      }
+
+      writeAll(j.fd_, &bufs_[j.id_][0], j.len_, j.offset_);
+
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        free_.push_back(j.id_);
+        --outstanding_;
+      }
+      done_.notify_all();
+    } // while
+  }
+
+  PWriteBackend::~PWriteBackend() {
+    Drain();
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      stop_ = true;
+    }
+    work_.notify_all();
+    for ( std::size_t i = 0; i < threads_.size(); ++i )
+      threads_[i].join();
+  }
+
+
+#ifdef WT_HAVE_IO_URING
+
+  namespace Details {
+
+    inline int ioUringSetup(unsigned entries, io_uring_params* p)
+      { return(static_cast<int>(::syscall(__NR_io_uring_setup, entries, p))); }
+
+    inline int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+      { return(static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, 0, 0))); }
+
+    inline int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned nargs)
+      { return(static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nargs))); }
+
+  } // namespace Details
+
+
+  //================
+  // IOUringBackend
+  //================
+
+  IOUringBackend::IOUringBackend(std::size_t queueDepth, std::size_t bufferBytes)
+      : WriteBackend(bufferBytes), ringfd_(-1), sqRing_(MAP_FAILED), cqRing_(MAP_FAILED),
+        sqes_(MAP_FAILED), sqRingSz_(0), cqRingSz_(0), sqesSz_(0), sqHead_(0), sqTail_(0),
+        sqMask_(0), sqArray_(0), cqHead_(0), cqTail_(0), cqMask_(0), cqes_(0),
+        mem_(static_cast<char*>(MAP_FAILED)), numBufs_(queueDepth), pending_(queueDepth),
+        outstanding_(0) {
+
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    ringfd_ = Details::ioUringSetup(static_cast<unsigned>(queueDepth), &p);
+    Ext::Assert<Ext::ProgramError>(ringfd_ >= 0, "io_uring_setup() unavailable");
+
+    // map the submission and completion rings, and the submission entries
+    sqRingSz_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqRingSz_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (p.features & IORING_FEAT_SINGLE_MMAP);
+    if ( single )
+      sqRingSz_ = cqRingSz_ = (sqRingSz_ > cqRingSz_) ? sqRingSz_ : cqRingSz_;
+    sqRing_ = ::mmap(0, sqRingSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQ_RING);
+    if ( sqRing_ != MAP_FAILED )
+      cqRing_ = single ? sqRing_ : ::mmap(0, cqRingSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_CQ_RING);
+    sqesSz_ = p.sq_entries * sizeof(io_uring_sqe);
+    if ( cqRing_ != MAP_FAILED )
+      sqes_ = ::mmap(0, sqesSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQES);
+    if ( sqes_ == MAP_FAILED ) {
+      release();
+      throw(Ext::ProgramError("io_uring ring mapping failed"));
+    }
+
+    char* sq = static_cast<char*>(sqRing_);
+    char* cq = static_cast<char*>(cqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sqMask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cqMask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_ = cq + p.cq_off.cqes;
+
+    // one registered buffer per possible in-flight write
+    mem_ = static_cast<char*>(::mmap(0, numBufs_ * bufferBytes_, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    std::vector<iovec> iov(numBufs_);
+    for ( std::size_t i = 0; mem_ != MAP_FAILED && i < numBufs_; ++i ) {
+      iov[i].iov_base = mem_ + i * bufferBytes_;
+      iov[i].iov_len = bufferBytes_;
+      free_.push_back(i);
+    } // for
+    if ( mem_ == MAP_FAILED ||
+         Details::ioUringRegister(ringfd_, IORING_REGISTER_BUFFERS, &iov[0], static_cast<unsigned>(numBufs_)) < 0 ) {
+      release();
+      throw(Ext::ProgramError("io_uring buffer registration failed"));
+    }
+  }
+
+  char* IOUringBackend::Acquire(std::size_t& id) {
+    while ( free_.empty() )
+      reap(true);
+    id = free_.back();
+    free_.pop_back();
+    return(mem_ + id * bufferBytes_);
+  }
+
+  void IOUringBackend::Write(int fd, std::size_t id, std::size_t len, long long offset) {
+    // outstanding writes never exceed numBufs_ <= sq_entries, so a slot is free
+    const unsigned tail = *sqTail_;
+    const unsigned idx = tail & *sqMask_;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + idx;
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = fd;
+    sqe->off = static_cast<unsigned long long>(offset);
+    sqe->addr = reinterpret_cast<unsigned long long>(mem_ + id * bufferBytes_);
+    sqe->len = static_cast<unsigned>(len);
+    sqe->buf_index = static_cast<unsigned short>(id);
+    sqe->user_data = id;
+    sqArray_[idx] = idx;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+    Pending pend = { fd, len, offset };
+    pending_[id] = pend;
+    ++outstanding_;
+    while ( Details::ioUringEnter(ringfd_, 1, 0, 0) < 0 ) {
+      if ( errno != EINTR && errno != EAGAIN && errno != EBUSY ) {
+        // could not submit -> take the entry back and write it ourselves, so
+        //  Drain() never waits on a completion that cannot come.  If the kernel
+        //  consumed the entry after all, its completion will be reaped as usual.
+        if ( __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) == tail ) {
+          __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+          writeAll(fd, mem_ + id * bufferBytes_, len, offset);
+          free_.push_back(id);
+          --outstanding_;
+        }
+        break;
+      }
+      reap(false);
+    } // while
+  }
+
+  void IOUringBackend::reap(bool wait) {
+    unsigned head = *cqHead_;
+    if ( wait && head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) && outstanding_ > 0 )
+      Details::ioUringEnter(ringfd_, 0, 1, IORING_ENTER_GETEVENTS);
+
+    while ( head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) ) {
+      const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & *cqMask_);
+      const std::size_t id = static_cast<std::size_t>(cqe->user_data);
+      const Pending& pend = pending_[id];
+      const std::size_t done = (cqe->res > 0) ? static_cast<std::size_t>(cqe->res) : 0;
+      if ( done < pend.len_ ) // short or failed write -> finish synchronously
+        writeAll(pend.fd_, mem_ + id * bufferBytes_ + done, pend.len_ - done, pend.offset_ + done);
+      free_.push_back(id);
+      --outstanding_;
+      __atomic_store_n(cqHead_, ++head, __ATOMIC_RELEASE);
+    } // while
+  }
+
+  void IOUringBackend::Drain() {
+    while ( outstanding_ > 0 )
+      reap(true);
+  }
+
+  void IOUringBackend::release() {
+    if ( mem_ != MAP_FAILED )
+      ::munmap(mem_, numBufs_ * bufferBytes_);
+    if ( sqes_ != MAP_FAILED )
+      ::munmap(sqes_, sqesSz_);
+    if ( cqRing_ != MAP_FAILED && cqRing_ != sqRing_ )
+      ::munmap(cqRing_, cqRingSz_);
+    if ( sqRing_ != MAP_FAILED )
+      ::munmap(sqRing_, sqRingSz_);
+    if ( ringfd_ >= 0 )
+      ::close(ringfd_);
+    mem_ = static_cast<char*>(MAP_FAILED);
+    sqes_ = cqRing_ = sqRing_ = MAP_FAILED;
+    ringfd_ = -1;
+  }
+
+  IOUringBackend::~IOUringBackend() {
+    Drain();
+    release();
+  }
+
+#endif // WT_HAVE_IO_URING
+
+
+  //===============
+  // makeBackend()
+  //===============
+  WriteBackend* makeBackend(const WriterOptions& opts) {
+    const std::size_t depth = (opts.queueDepth_ > 0) ? opts.queueDepth_ : 1;
+#ifdef WT_HAVE_IO_URING
+    if ( opts.backend_ != WriterOptions::PWRITE ) {
+      try {
+        return(new IOUringBackend(depth, opts.bufferBytes_));
+      } catch(Ext::ProgramError& pe) {
+        // only AUTO falls back ; an explicit request must not be ignored
+        Ext::Assert<Ext::UserError>(opts.backend_ == WriterOptions::AUTO, "--io-backend io_uring", pe.what());
+      }
+    }
+#else
+    Ext::Assert<Ext::UserError>(opts.backend_ != WriterOptions::IO_URING, "--io-backend io_uring", "not supported by this build");
+#endif
+    return(new PWriteBackend(depth, opts.bufferBytes_));
+  }
+
+} // namespace WT
@@ -0,0 +1,182 @@
+/*
+  FILE: WTOutput.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 11:02:17 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef WT_OUTPUT_FRAMEWORK_HPP
+#define WT_OUTPUT_FRAMEWORK_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WT_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace WT {
+
+  //===============
+  // WriterOptions : process-wide settings used by every BlockWriter
+  //===============
+  /*
+    Backend AUTO tries io_uring first and falls back to a pool of pwrite()
+    threads when the kernel (or a sandbox) does not allow io_uring.  An
+    explicit IO_URING never falls back: makeBackend() throws Ext::UserError.
+    queueDepth_ is the number of writes that may be outstanding at once per
+    output stream, and is also the number of registered buffers of size
+    bufferBytes_.  When binary_ is set, values are written in native binary
+    form rather than as formatted text.
+  */
+  struct WriterOptions {
+    enum Backend { AUTO, IO_URING, PWRITE };
+
+    WriterOptions() : backend_(AUTO), queueDepth_(8), bufferBytes_(1 << 18), binary_(false)
+      { /* */ }
+
+    Backend backend_;
+    std::size_t queueDepth_;
+    std::size_t bufferBytes_;
+    bool binary_;
+  };
+
+  WriterOptions& writerOptions();
+
+  //===============
+  // WriteBackend
+  //===============
+  /*
+    Asynchronous positional writes from a fixed set of buffers.  A caller
+    Acquire()s a free buffer, fills it and hands it to Write(), after which
+    the buffer belongs to the backend until that write completes.  Drain()
+    waits for every outstanding write.  All member functions are meant to be
+    called from a single thread.
+  */
+  struct WriteBackend {
+    virtual ~WriteBackend() { /* */ }
+    virtual char* Acquire(std::size_t& id) = 0;
+    virtual void Write(int fd, std::size_t id, std::size_t len, long long offset) = 0;
+    virtual void Drain() = 0;
+    virtual std::string Name() const = 0;
+    std::size_t BufferBytes() const { return(bufferBytes_); }
+
+    // synchronous helper ; offset < 0 -> write() at the current position
+    static void writeAll(int fd, const char* buf, std::size_t len, long long offset);
+
+  protected:
+    explicit WriteBackend(std::size_t bufferBytes) : bufferBytes_(bufferBytes)
+      { /* */ }
+
+    const std::size_t bufferBytes_;
+  };
+
+  //===============
+  // PWriteBackend : fallback pool of threads calling pwrite()
+  //===============
+  struct PWriteBackend : public WriteBackend {
+    PWriteBackend(std::size_t queueDepth, std::size_t bufferBytes, std::size_t numThreads = 2);
+    char* Acquire(std::size_t& id);
+    void Write(int fd, std::size_t id, std::size_t len, long long offset);
+    void Drain();
+    std::string Name() const { return("pwrite"); }
+    ~PWriteBackend();
+
+  private:
+    struct Job {
+      int fd_;
+      std::size_t id_, len_;
+      long long offset_;
+    };
+
+    void run();
+
+  private:
+    std::vector< std::vector<char> > bufs_;
+    std::vector<std::size_t> free_;
+    std::deque<Job> jobs_;
+    std::size_t outstanding_;
+    bool stop_;
+    std::mutex mtx_;
+    std::condition_variable work_, done_;
+    std::vector<std::thread> threads_;
+  };
+
+#ifdef WT_HAVE_IO_URING
+  //================
+  // IOUringBackend : registered buffers + IORING_OP_WRITE_FIXED
+  //================
+  /*
+    The constructor throws Ext::ProgramError when the kernel refuses to set
+    up a ring, so callers can fall back to PWriteBackend.
+  */
+  struct IOUringBackend : public WriteBackend {
+    IOUringBackend(std::size_t queueDepth, std::size_t bufferBytes);
+    char* Acquire(std::size_t& id);
+    void Write(int fd, std::size_t id, std::size_t len, long long offset);
+    void Drain();
+    std::string Name() const { return("io_uring"); }
+    ~IOUringBackend();
+
+  private:
+    IOUringBackend(const IOUringBackend&); // not copyable
+    IOUringBackend& operator=(const IOUringBackend&);
+
+    void reap(bool wait);
+    void release();
+
+  private:
+    struct Pending {
+      int fd_;
+      std::size_t len_;
+      long long offset_;
+    };
+
+    int ringfd_;
+    void *sqRing_, *cqRing_, *sqes_;
+    std::size_t sqRingSz_, cqRingSz_, sqesSz_;
+    unsigned *sqHead_, *sqTail_, *sqMask_, *sqArray_;
+    unsigned *cqHead_, *cqTail_, *cqMask_;
+    void* cqes_;
+    char* mem_;
+    std::size_t numBufs_;
+    std::vector<std::size_t> free_;
+    std::vector<Pending> pending_;
+    std::size_t outstanding_;
+  };
+#endif // WT_HAVE_IO_URING
+
+  //===============
+  // makeBackend() : per writerOptions(), with fallback to pwrite() for AUTO
+  //===============
+  WriteBackend* makeBackend(const WriterOptions& opts);
+
+} // namespace WT
+
+#include "WTOutput.cpp"
+
+#endif // WT_OUTPUT_FRAMEWORK_HPP
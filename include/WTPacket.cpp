@@ -0,0 +1,177 @@
+/*
+  FILE: WTPacket.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 14:02:11 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTPacket.hpp"
+
+
+namespace WT {
+
+  //===========
+  // PacketSet
+  //===========
+
+  void PacketSet::Add(int level, int index) {
+    Ext::Assert<Ext::ArgumentError>(level >= 0 && index >= 0 && (level >= 31 || index < (1 << level)),
+                                    "PacketSet::Add()", "no such packet node");
+    nodes_.insert(std::make_pair(level, index));
+  }
+
+  bool PacketSet::Emit(int level, int index) const
+    { return(nodes_.count(std::make_pair(level, index)) > 0); }
+
+  bool PacketSet::Descend(int level, int index) const {
+    // any wanted node deeper than 'level' whose ancestor at 'level' is 'index'
+    std::set< std::pair<int, int> >::const_iterator i = nodes_.upper_bound(std::make_pair(level, index));
+    for ( ; i != nodes_.end(); ++i ) {
+      if ( i->first > level && (i->second >> (i->first - level)) == index )
+        return(true);
+    } // for
+    return(false);
+  }
+
+  int PacketSet::MaxLevel() const
+    { return(nodes_.empty() ? 0 : nodes_.rbegin()->first); }
+
+
+  namespace Details {
+
+    //==============
+    // PacketLevel : the two children of the node being split at one depth
+    //==============
+    template <typename Sequence>
+    struct PacketLevel {
+      explicit PacketLevel(std::size_t N) : scaling_(N, 0), wavelet_(N, 0)
+        { /* */ }
+      Sequence scaling_, wavelet_;
+    };
+
+    //=================
+    // modwpt_descend() : split node (j, n) held in Vi, then visit its children
+    //=================
+    template <
+              typename Sequence,
+              typename WaveletFilter,
+              typename ScalingFilter,
+              typename NodeSelect,
+              typename PacketOp
+             >
+    void modwpt_descend(const Sequence& Vi, int j, int n, const WaveletFilter& wavefilt,
+                        const ScalingFilter& scalefilt, const NodeSelect& select, PacketOp& op,
+                        std::vector< PacketLevel<Sequence>* >& levels) {
+
+      const int child[2] = { 2*n, 2*n+1 };
+      bool wanted = false;
+      for ( int c = 0; c < 2; ++c )
+        wanted = wanted || select.Emit(j+1, child[c]) || select.Descend(j+1, child[c]);
+      if ( !wanted )
+        return;
+
+      if ( static_cast<int>(levels.size()) <= j )
+        levels.push_back(new PacketLevel<Sequence>(Vi.size()));
+      PacketLevel<Sequence>& lvl = *levels[j];
+      DoNothing nothing;
+      Details::modwt_forward(Vi, wavefilt, scalefilt, j, lvl.scaling_, lvl.wavelet_, nothing, nothing);
+
+      // sequency ordering: child c uses the scaling filter when c % 4 is 0 or 3,
+      //  so the scaling filter yields the even child of an even node only
+      const bool scalingFirst = (n % 2 == 0);
+      const Sequence* node[2] = { &lvl.scaling_, &lvl.wavelet_ };
+      if ( !scalingFirst )
+        std::swap(node[0], node[1]);
+
+      const std::size_t N = static_cast<std::size_t>(Vi.size());
+      for ( int c = 0; c < 2; ++c ) {
+        if ( select.Emit(j+1, child[c]) ) {
+          op.Node(j+1, child[c]);
+          for ( std::size_t t = 0; t < N; ++t )
+            op((*node[c])[t]);
+        }
+        if ( select.Descend(j+1, child[c]) ) // reuses levels[j+1] and below
+          modwpt_descend(*node[c], j+1, child[c], wavefilt, scalefilt, select, op, levels);
+      } // for
+    }
+
+  } // namespace Details
+
+
+  //==========
+  // modwpt()
+  //==========
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename NodeSelect,
+            typename PacketOp
+           >
+  void modwpt(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+              const NodeSelect& select, PacketOp& op) {
+
+    Ext::Assert<Ext::ArgumentError>(!X.empty(), "modwpt()", "empty input");
+    double expsz = select.MaxLevel() - 1;
+    Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), "modwpt()", "wavelet xfm exceeds sample size");
+
+    if ( select.Emit(0, 0) ) {
+      op.Node(0, 0);
+      for ( std::size_t t = 0; t < static_cast<std::size_t>(X.size()); ++t )
+        op(X[t]);
+    }
+
+    std::vector< Details::PacketLevel<Sequence>* > levels; // one per depth reached
+    try {
+      if ( select.Descend(0, 0) )
+        Details::modwpt_descend(X, 0, 0, wavefilt, scalefilt, select, op, levels);
+    } catch(...) {
+      for ( std::size_t i = 0; i < levels.size(); ++i )
+        delete levels[i];
+      throw;
+    }
+    for ( std::size_t i = 0; i < levels.size(); ++i )
+      delete levels[i];
+  }
+
+
+  //==========
+  // modwpt() : given a filter type
+  //==========
+  template <
+            typename Sequence,
+            typename NodeSelect,
+            typename PacketOp
+           >
+  void modwpt(const Sequence& X, Filter::FType filterType, const NodeSelect& select, PacketOp& op) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwpt(X, filters.first, filters.second, select, op);
+  }
+
+} // namespace WT
@@ -0,0 +1,114 @@
+/*
+  FILE: WTPacket.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 14:02:11 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_PACKET_FRAMEWORK_HPP
+#define WT_PACKET_FRAMEWORK_HPP
+
+#include <set>
+#include <utility>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* The maximal overlap discrete wavelet packet transform (MODWPT) splits every
+      node, not only the scaling branch, with both the wavelet and the scaling
+      filter.  Level j then has 2^j nodes W_{j,n}, n = 0..2^j-1, each of N
+      coefficients and each covering a frequency band of width 1/2^(j+1).
+      Nodes are numbered in sequency (frequency) order as in Percival & Walden
+      section 6.3: node n at level j has children 2n and 2n+1 at level j+1,
+      and the scaling filter produces child c exactly when c mod 4 is 0 or 3.
+  */
+
+  //===========
+  // PacketSet : which packet nodes modwpt() should compute and emit
+  //===========
+  // o a NodeSelect for modwpt() needs two const member functions:
+  //    Emit(level, index)    -> send node W_{level,index} to the op
+  //    Descend(level, index) -> some node below W_{level,index} is wanted
+  // o TerminalNodes wants every node at one level (a full tree)
+  // o PacketSet wants an explicit list of nodes, such as a best basis ; only
+  //    the paths from the root to those nodes are ever computed
+  //===========
+  struct TerminalNodes {
+    explicit TerminalNodes(int level) : level_(level)
+      { /* */ }
+    bool Emit(int level, int index) const { return(level == level_); }
+    bool Descend(int level, int index) const { return(level < level_); }
+    int MaxLevel() const { return(level_); }
+
+  private:
+    int level_;
+  };
+
+  struct PacketSet {
+    void Add(int level, int index);
+    bool Emit(int level, int index) const;
+    bool Descend(int level, int index) const;
+    int MaxLevel() const;
+    bool Empty() const { return(nodes_.empty()); }
+
+  private:
+    std::set< std::pair<int, int> > nodes_;
+  };
+
+
+  //==========
+  // modwpt() : maximal overlap discrete wavelet packet transform
+  //==========
+  // o 'X' is not modified ; it is the root node W_{0,0}
+  // o the tree is walked depth-first, so at most two N-sized buffers per level
+  //    are alive at once, however many nodes are wanted
+  // o for every node that select.Emit() accepts, op.Node(level, index) is called
+  //    and then op is called with the N coefficients of that node.  Nodes come
+  //    out in depth-first order: each node before the nodes below it.
+  // o ops without a Node() member can derive from DoNothing ; see PrintNodes
+  //==========
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename NodeSelect,    // TerminalNodes, PacketSet or similar
+            typename PacketOp       // Op given Node() and then N coefficients per node
+           >
+  void modwpt(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+              const NodeSelect& select, PacketOp& op);
+
+
+  //==========
+  // modwpt() : overload taking a filter type rather than the filters themselves
+  //==========
+  template <
+            typename Sequence,
+            typename NodeSelect,
+            typename PacketOp
+           >
+  void modwpt(const Sequence& X, Filter::FType filterType, const NodeSelect& select, PacketOp& op);
+
+} // namespace WT
+
+#include "WTPacket.cpp"
+
+#endif // WT_PACKET_FRAMEWORK_HPP
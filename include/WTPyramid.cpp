@@ -0,0 +1,254 @@
+/*
+  FILE: WTPyramid.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 16:27:52 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTPyramid.hpp"
+
+
+namespace WT {
+
+  namespace Details {
+    static const char PyramidMagic[8] = { 'W', 'T', 'P', 'Y', 'R', 'M', 'D', '1' };
+    static const std::size_t PyramidHeader = sizeof(PyramidMagic) + 2 * sizeof(unsigned long long);
+  } // namespace Details
+
+
+  //=============
+  // TileSummary
+  //=============
+
+  TileSummary::TileSummary()
+      : min_(std::numeric_limits<double>::max()), max_(-std::numeric_limits<double>::max()),
+        sum_(0), sumsq_(0), count_(0)
+    { /* */ }
+
+  inline void TileSummary::Add(double v) {
+    min_ = std::min(min_, v);
+    max_ = std::max(max_, v);
+    sum_ += v;
+    sumsq_ += v * v;
+    ++count_;
+  }
+
+  void TileSummary::Merge(const TileSummary& other) {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    sumsq_ += other.sumsq_;
+    count_ += other.count_;
+  }
+
+  double TileSummary::Mean() const
+    { return(count_ ? sum_ / count_ : 0); }
+
+
+  //==============
+  // PyramidIndex
+  //==============
+
+  PyramidIndex::PyramidIndex(const std::string& filename, std::size_t tile, std::size_t fanout)
+      : fptr_(std::fopen(filename.c_str(), "wb")), tile_(tile), fanout_(fanout), offset_(0) {
+    Ext::Assert<Ext::InvalidFile>(fptr_ != 0, "Unable to open file for writing: " + filename);
+    Ext::Assert<Ext::ArgumentError>(tile > 0 && fanout > 1, "PyramidIndex", "need tile > 0 and fanout > 1");
+    const unsigned long long zeros[2] = { 0, 0 }; // directory offset and size ; filled by Close()
+    put(Details::PyramidMagic, sizeof(Details::PyramidMagic));
+    put(zeros, sizeof(zeros));
+  }
+
+  void PyramidIndex::put(const void* p, std::size_t sz) {
+    Ext::Assert<Ext::InvalidFile>(sz == 0 || std::fwrite(p, 1, sz, fptr_) == sz, "PyramidIndex: write failed");
+    offset_ += sz;
+  }
+
+  std::size_t PyramidIndex::Begin(const std::string& track) {
+    tracks_.push_back(Track());
+    tracks_.back().name_ = track;
+    tracks_.back().count_ = 0;
+    tracks_.back().open_ = true;
+    return(tracks_.size() - 1);
+  }
+
+  inline void PyramidIndex::Add(std::size_t id, double v) {
+    std::vector<TileSummary>& tiles = tracks_[id].tiles_;
+    if ( tiles.empty() || tiles.back().count_ == tile_ )
+      tiles.push_back(TileSummary());
+    tiles.back().Add(v);
+    ++tracks_[id].count_;
+  }
+
+  void PyramidIndex::End(std::size_t id) {
+    Track& t = tracks_[id];
+    if ( !t.open_ )
+      return;
+    t.open_ = false;
+
+    // resolution r has tiles of tile_ * fanout_^r values ; the last one has a single tile
+    std::vector<TileSummary> current, next;
+    current.swap(t.tiles_);
+    unsigned long long sz = tile_;
+    while ( !current.empty() ) {
+      Resolution r = { sz, current.size(), offset_ };
+      t.res_.push_back(r);
+      put(&current[0], current.size() * sizeof(TileSummary));
+      if ( current.size() == 1 )
+        break;
+      next.assign((current.size() + fanout_ - 1) / fanout_, TileSummary());
+      for ( std::size_t i = 0; i < current.size(); ++i )
+        next[i / fanout_].Merge(current[i]);
+      current.swap(next);
+      sz *= fanout_;
+    } // while
+  }
+
+  void PyramidIndex::Close() {
+    if ( !fptr_ )
+      return;
+    unsigned long long used = 0;
+    for ( std::size_t i = 0; i < tracks_.size(); ++i ) {
+      End(i);
+      used += (tracks_[i].count_ > 0);
+    } // for
+    const unsigned long long dir[2] = { offset_, used };
+    for ( std::size_t i = 0; i < tracks_.size(); ++i ) {
+      const Track& t = tracks_[i];
+      if ( t.count_ == 0 ) // opened but nothing printed
+        continue;
+      const unsigned long long sizes[3] = { t.name_.size(), t.count_, t.res_.size() };
+      put(sizes, sizeof(sizes));
+      put(t.name_.data(), t.name_.size());
+      for ( std::size_t j = 0; j < t.res_.size(); ++j )
+        put(&t.res_[j], sizeof(Resolution));
+    } // for
+    Ext::Assert<Ext::InvalidFile>(0 == std::fseek(fptr_, sizeof(Details::PyramidMagic), SEEK_SET) &&
+                                  std::fwrite(dir, sizeof(dir), 1, fptr_) == 1 &&
+                                  0 == std::fclose(fptr_), "PyramidIndex: write failed");
+    fptr_ = 0;
+  }
+
+  PyramidIndex::~PyramidIndex() {
+    try {
+      Close();
+    } catch(...) { /* never throw from a destructor */ }
+  }
+
+
+  //===============
+  // PyramidReader
+  //===============
+
+  PyramidReader::PyramidReader(const std::string& filename) : map_(0), bytes_(0) {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    Ext::Assert<Ext::InvalidFile>(fd >= 0, "Unable to open file for reading: " + filename);
+    struct stat st;
+    const bool sized = (0 == ::fstat(fd, &st)) && static_cast<std::size_t>(st.st_size) >= Details::PyramidHeader;
+    void* mem = sized ? ::mmap(0, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    Ext::Assert<Ext::InvalidFile>(mem != MAP_FAILED, "Not a pyramid file: " + filename);
+    map_ = static_cast<const char*>(mem);
+    bytes_ = static_cast<std::size_t>(st.st_size);
+
+    bool ok = (0 == std::memcmp(map_, Details::PyramidMagic, sizeof(Details::PyramidMagic)));
+    unsigned long long dir[2] = { 0, 0 };
+    std::memcpy(dir, map_ + sizeof(Details::PyramidMagic), sizeof(dir));
+    std::size_t at = static_cast<std::size_t>(dir[0]);
+    for ( unsigned long long i = 0; ok && i < dir[1]; ++i ) {
+      unsigned long long sizes[3];
+      ok = (at + sizeof(sizes) <= bytes_);
+      if ( ok )
+        std::memcpy(sizes, map_ + at, sizeof(sizes)), at += sizeof(sizes);
+      ok = ok && (at + sizes[0] + sizes[2] * sizeof(Resolution) <= bytes_);
+      if ( !ok )
+        break;
+      Track t;
+      t.count_ = sizes[1];
+      t.res_.resize(sizes[2]);
+      const std::string name(map_ + at, sizes[0]);
+      at += sizes[0];
+      if ( sizes[2] )
+        std::memcpy(&t.res_[0], map_ + at, sizes[2] * sizeof(Resolution));
+      at += sizes[2] * sizeof(Resolution);
+      for ( std::size_t j = 0; ok && j < t.res_.size(); ++j )
+        ok = (t.res_[j].offset_ + t.res_[j].tiles_ * sizeof(TileSummary) <= bytes_);
+      tracks_[name] = t; // a later track of the same name replaces an earlier one, like the file it came from
+    } // for
+    if ( !ok )
+      ::munmap(const_cast<char*>(map_), bytes_);
+    Ext::Assert<Ext::InvalidFile>(ok, "Corrupt or unfinished pyramid file: " + filename);
+  }
+
+  std::vector<std::string> PyramidReader::Tracks() const {
+    std::vector<std::string> names;
+    for ( std::map<std::string, Track>::const_iterator i = tracks_.begin(); i != tracks_.end(); ++i )
+      names.push_back(i->first);
+    return(names);
+  }
+
+  const PyramidReader::Track& PyramidReader::find(const std::string& track) const {
+    std::map<std::string, Track>::const_iterator i = tracks_.find(track);
+    Ext::Assert<Ext::ArgumentError>(i != tracks_.end(), "PyramidReader", "no such track: " + track);
+    return(i->second);
+  }
+
+  std::size_t PyramidReader::Size(const std::string& track) const
+    { return(static_cast<std::size_t>(find(track).count_)); }
+
+  std::size_t PyramidReader::Query(const std::string& track, std::size_t first, std::size_t last,
+                                   std::size_t resolution, std::vector<TileSummary>& out) const {
+    const Track& t = find(track);
+    out.clear();
+    last = std::min<std::size_t>(last, t.count_);
+    if ( first >= last )
+      return(t.res_.empty() ? 0 : t.res_[0].tile_);
+
+    std::size_t r = 0;
+    while ( r + 1 < t.res_.size() && t.res_[r+1].tile_ <= resolution )
+      ++r;
+    const Resolution& res = t.res_[r];
+    const std::size_t sz = static_cast<std::size_t>(res.tile_);
+    const std::size_t a = first / sz, b = (last - 1) / sz + 1;
+    out.resize(b - a);
+    std::memcpy(&out[0], map_ + res.offset_ + a * sizeof(TileSummary), (b - a) * sizeof(TileSummary));
+    return(sz);
+  }
+
+  PyramidReader::~PyramidReader()
+    { ::munmap(const_cast<char*>(map_), bytes_); }
+
+} // namespace WT
@@ -0,0 +1,153 @@
+/*
+  FILE: WTPyramid.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 16:27:52 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_PYRAMID_FRAMEWORK_HPP
+#define WT_PYRAMID_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WT {
+
+  //==============
+  // TileSummary : what a pyramid keeps per tile of consecutive values
+  //==============
+  struct TileSummary {
+    TileSummary();
+
+    void Add(double v);
+    void Merge(const TileSummary& other);
+    double Mean() const;
+
+    double min_, max_, sum_, sumsq_;
+    unsigned long long count_;
+  };
+
+
+  //==============
+  // PyramidIndex : multiresolution tile summaries of many waveforms, in one file
+  //==============
+  /*
+    Each waveform (track) is started by Begin(name), which returns an id for
+    Add()ing its values and for End().  Tracks may be open at the same time,
+    as doAll() produces several waveforms at once.  Resolution 0 summarizes
+    tiles of 'tile' values, and each coarser resolution merges 'fanout'
+    tiles of the one below, down to a single tile.  Tiles of a resolution
+    are fixed-size records stored back to back, so the offset of any tile
+    is computed rather than searched for.  A track's records are written
+    at End(), and a directory of all tracks at Close(), which reports a
+    failed write, or at destruction, which cannot.  File layout, native
+    byte order:
+      header    : "WTPYRMD1", directory offset, number of tracks
+      records   : TileSummary's
+      directory : per track its name, value count and resolutions, each as
+                  (tile size, tile count, file offset)
+    PrintValues::Index() feeds one of these with every value it prints, so
+    the pyramid is built in the same pass as the text output.
+  */
+  struct PyramidIndex {
+    explicit PyramidIndex(const std::string& filename, std::size_t tile = 64, std::size_t fanout = 4);
+
+    std::size_t Begin(const std::string& track);
+    void Add(std::size_t id, double v);
+    void End(std::size_t id);
+    void Close();
+    ~PyramidIndex();
+
+  private:
+    PyramidIndex(const PyramidIndex&); // not copyable
+    PyramidIndex& operator=(const PyramidIndex&);
+
+    struct Resolution {
+      unsigned long long tile_, tiles_, offset_;
+    };
+
+    struct Track {
+      std::string name_;
+      unsigned long long count_;
+      std::vector<Resolution> res_;
+      std::vector<TileSummary> tiles_; // resolution 0 while open
+      bool open_;
+    };
+
+    void put(const void* p, std::size_t sz);
+
+  private:
+    FILE* fptr_;
+    const std::size_t tile_, fanout_;
+    unsigned long long offset_;
+    std::vector<Track> tracks_;
+  };
+
+
+  //===============
+  // PyramidReader : answers (track, range, resolution) queries from a PyramidIndex file
+  //===============
+  /*
+    The file is memory mapped.  Query() picks the coarsest resolution whose
+    tiles hold no more than 'resolution' values (resolution 0 if none do), and
+    returns the tiles overlapping positions [first, last) of the track, along
+    with their size.  Finding the track costs O(log #tracks) and the rest is
+    proportional to the number of tiles returned.
+    Track names are the output file names, such as details.3 or smoothing.6.
+  */
+  struct PyramidReader {
+    explicit PyramidReader(const std::string& filename);
+
+    std::vector<std::string> Tracks() const;
+    std::size_t Size(const std::string& track) const; // number of values
+    std::size_t Query(const std::string& track, std::size_t first, std::size_t last,
+                      std::size_t resolution, std::vector<TileSummary>& out) const;
+    ~PyramidReader();
+
+  private:
+    PyramidReader(const PyramidReader&); // not copyable
+    PyramidReader& operator=(const PyramidReader&);
+
+    struct Resolution {
+      unsigned long long tile_, tiles_, offset_;
+    };
+
+    struct Track {
+      unsigned long long count_;
+      std::vector<Resolution> res_;
+    };
+
+    const Track& find(const std::string& track) const;
+
+  private:
+    const char* map_;
+    std::size_t bytes_;
+    std::map<std::string, Track> tracks_;
+  };
+
+} // namespace WT
+
+#include "WTPyramid.cpp"
+
+#endif // WT_PYRAMID_FRAMEWORK_HPP
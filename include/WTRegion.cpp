@@ -0,0 +1,229 @@
+/*
+  FILE: WTRegion.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 15:41:09 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTRegion.hpp"
+
+
+namespace WT {
+
+  namespace Details {
+
+    //===============
+    // region_halo() : how far a level j value reaches into its input ; (L-1)(2^j - 1)
+    //===============
+    inline std::size_t region_halo(std::size_t L, int j)
+      { return((L - 1) * ((static_cast<std::size_t>(1) << j) - 1)); }
+
+    //===============
+    // region_load() : buf = X over [from, from + n) of its periodic extension
+    //===============
+    template <typename Sequence, typename Buffer>
+    void region_load(const Sequence& X, long long from, std::size_t n, Buffer& buf) {
+      const long long N = static_cast<long long>(X.size());
+      long long r = from % N;
+      if ( r < 0 )
+        r += N;
+      buf.resize(n);
+      for ( std::size_t u = 0; u < n; ++u ) {
+        buf[u] = X[static_cast<std::size_t>(r)];
+        if ( ++r == N )
+          r = 0;
+      } // for
+    }
+
+    //====================
+    // region_forward() : one modwt_forward() step in place, back-filtering with 'filt'
+    //====================
+    // o buf[u] becomes the filtered value at the position of the old buf[u + (L-1)D]
+    // o sums in the same order as modwt_forward() ; buf shrinks by (L-1)D
+    //====================
+    template <typename Buffer, typename Filter>
+    void region_forward(Buffer& buf, const Filter& filt, std::size_t D) {
+      const std::size_t L = static_cast<std::size_t>(filt.size());
+      const std::size_t reach = (L - 1) * D;
+      const std::size_t n = buf.size() - reach;
+      for ( std::size_t u = 0; u < n; ++u ) {
+        typename Buffer::value_type v = filt[0] * buf[u + reach];
+        for ( std::size_t l = 1; l < L; ++l )
+          v += filt[l] * buf[u + reach - l * D];
+        buf[u] = v; // every read is at or beyond u
+      } // for
+      buf.resize(n);
+    }
+
+    //=====================
+    // region_backward() : one imodwt_backward_zerophase() step in place
+    //=====================
+    // o buf[u] becomes the filtered value at the position of the old buf[u] ; buf shrinks by (L-1)D
+    //=====================
+    template <typename Buffer, typename Filter>
+    void region_backward(Buffer& buf, const Filter& filt, std::size_t D) {
+      const std::size_t L = static_cast<std::size_t>(filt.size());
+      const std::size_t n = buf.size() - (L - 1) * D;
+      for ( std::size_t u = 0; u < n; ++u ) {
+        typename Buffer::value_type v = filt[0] * buf[u];
+        for ( std::size_t l = 1; l < L; ++l )
+          v += filt[l] * buf[u + l * D];
+        buf[u] = v;
+      } // for
+      buf.resize(n);
+    }
+
+    //==================
+    // region_checks() : common argument checks
+    //==================
+    template <typename Sequence>
+    void region_checks(const Sequence& X, int numLevels, std::size_t first, std::size_t last, const char* who) {
+      Ext::Assert<Ext::ArgumentError>(numLevels > 0, who, "level must be > 0");
+      Ext::Assert<Ext::ArgumentError>(first < last && last <= static_cast<std::size_t>(X.size()), who, "bad region");
+      double expsz = numLevels - 1;
+      Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), who, "wavelet xfm exceeds sample size");
+    }
+
+  } // namespace Details
+
+
+  //================
+  // modwt_region()
+  //================
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_region(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                    int numLevels, std::size_t first, std::size_t last, VOp& vop, WOp& wop) {
+
+    typedef typename Sequence::value_type T;
+    Details::region_checks(X, numLevels, first, last, "modwt_region()");
+    const std::size_t L = static_cast<std::size_t>(wavefilt.size());
+    const std::size_t n = last - first, H = Details::region_halo(L, numLevels);
+
+    // V_j for all j in one buffer ; it starts at first - H and its front is
+    //  used up by each step, so level j starts at first - (H - halo(j))
+    std::vector<T> V, W(n);
+    Details::region_load(X, static_cast<long long>(first) - static_cast<long long>(H), n + H, V);
+    for ( int j = 1; j <= numLevels; ++j ) {
+      vop.Level(j);
+      wop.Level(j);
+      const std::size_t D = static_cast<std::size_t>(1) << (j - 1);
+      const std::size_t reach = (L - 1) * D, offset = H - Details::region_halo(L, j);
+      for ( std::size_t u = 0; u < n; ++u ) { // W_j, in the region only
+        const std::size_t at = offset + u + reach;
+        W[u] = wavefilt[0] * V[at];
+        for ( std::size_t l = 1; l < L; ++l )
+          W[u] += wavefilt[l] * V[at - l * D];
+      } // for
+      Details::region_forward(V, scalefilt, D);
+
+      for ( std::size_t u = 0; u < n; ++u ) {
+        vop(V[offset + u]);
+        wop(W[u]);
+      } // for
+    } // for
+  }
+
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_region(const Sequence& X, Filter::FType filterType, int numLevels,
+                    std::size_t first, std::size_t last, VOp& vop, WOp& wop) {
+    typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> Filts;
+    Filts filters = WT::Filter::getFilters<WT::MODWT>(filterType);
+    modwt_region(X, filters.first, filters.second, numLevels, first, last, vop, wop);
+  }
+
+
+  //=================
+  // smooth_region()
+  //=================
+  template <
+            typename Sequence,
+            typename ScalingFilter,
+            typename SmoothOp
+           >
+  void smooth_region(const Sequence& X, const ScalingFilter& scalefilt, int numLevels,
+                     std::size_t first, std::size_t last, SmoothOp& sop) {
+
+    typedef typename Sequence::value_type T;
+    Details::region_checks(X, numLevels, first, last, "smooth_region()");
+    const std::size_t n = last - first, H = Details::region_halo(scalefilt.size(), numLevels);
+
+    std::vector<T> K;
+    Details::region_load(X, static_cast<long long>(first) - static_cast<long long>(H), n + 2 * H, K);
+    for ( int j = 0; j < numLevels; ++j ) // V_J over [first, last + H)
+      Details::region_forward(K, scalefilt, static_cast<std::size_t>(1) << j);
+    for ( int j = numLevels - 1; j >= 0; --j ) // as smooth() does
+      Details::region_backward(K, scalefilt, static_cast<std::size_t>(1) << j);
+
+    sop.Level(numLevels);
+    for ( std::size_t u = 0; u < n; ++u )
+      sop(K[u]);
+  }
+
+
+  //=================
+  // detail_region()
+  //=================
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailOp
+           >
+  void detail_region(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                     int level, std::size_t first, std::size_t last, DetailOp& dop) {
+
+    typedef typename Sequence::value_type T;
+    Details::region_checks(X, level, first, last, "detail_region()");
+    const std::size_t n = last - first, H = Details::region_halo(wavefilt.size(), level);
+
+    std::vector<T> K;
+    Details::region_load(X, static_cast<long long>(first) - static_cast<long long>(H), n + 2 * H, K);
+    const std::size_t D = static_cast<std::size_t>(1) << (level - 1);
+    for ( int j = 0; j < level - 1; ++j ) // V_{level-1}, then W_level over [first, last + H)
+      Details::region_forward(K, scalefilt, static_cast<std::size_t>(1) << j);
+    Details::region_forward(K, wavefilt, D);
+    for ( int j = 0; j < level - 1; ++j ) // as details_one() does
+      Details::region_backward(K, scalefilt, static_cast<std::size_t>(1) << j);
+    Details::region_backward(K, wavefilt, D);
+
+    dop.Level(level);
+    for ( std::size_t u = 0; u < n; ++u )
+      dop(K[u]);
+  }
+
+} // namespace WT
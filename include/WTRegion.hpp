@@ -0,0 +1,102 @@
+/*
+  FILE: WTRegion.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 15:41:09 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_REGION_FRAMEWORK_HPP
+#define WT_REGION_FRAMEWORK_HPP
+
+#include <cstddef>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  /* Region queries: level-j values over [first, last) without transforming
+      the whole series.  V_j[t] depends on X only through the (L-1)(2^j - 1)
+      values before t, and the inverse (zero-phase) steps behind smooth and
+      details look as far ahead, so each query runs the cascade over the
+      region plus that halo, read periodically from X.  Cost scales with
+      (last - first) + (L-1)2^j rather than with N.  Results equal those of
+      the whole-series functions at the same positions.
+  */
+
+  //================
+  // modwt_region() : modwt() restricted to positions [first, last)
+  //================
+  // o ops are called as modwt() calls them, but with last - first values per level
+  // o 'X' is not modified
+  // o first < last <= X.size()
+  //================
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename VOp,           // Op called for each scaling coeff in the region
+            typename WOp            // Op called for each wavelet coeff in the region
+           >
+  void modwt_region(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                    int numLevels, std::size_t first, std::size_t last, VOp& vop, WOp& wop);
+
+  template <
+            typename Sequence,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_region(const Sequence& X, Filter::FType filterType, int numLevels,
+                    std::size_t first, std::size_t last, VOp& vop, WOp& wop);
+
+
+  //=================
+  // smooth_region() : the level 'numLevels' smooth over [first, last), straight from 'X'
+  //=================
+  // o sop.Level(numLevels) is called once, followed by last - first values
+  //=================
+  template <
+            typename Sequence,
+            typename ScalingFilter,
+            typename SmoothOp
+           >
+  void smooth_region(const Sequence& X, const ScalingFilter& scalefilt, int numLevels,
+                     std::size_t first, std::size_t last, SmoothOp& sop);
+
+
+  //=================
+  // detail_region() : the level 'level' detail over [first, last), straight from 'X'
+  //=================
+  // o dop.Level(level) is called once, followed by last - first values
+  //=================
+  template <
+            typename Sequence,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailOp
+           >
+  void detail_region(const Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                     int level, std::size_t first, std::size_t last, DetailOp& dop);
+
+} // namespace WT
+
+#include "WTRegion.cpp"
+
+#endif // WT_REGION_FRAMEWORK_HPP
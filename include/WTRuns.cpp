@@ -0,0 +1,353 @@
+/*
+  FILE: WTRuns.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 17:14:36 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "WTRuns.hpp"
+
+
+namespace WT {
+
+  //===========
+  // RunSeries
+  //===========
+
+  template <typename T>
+  RunSeries<T>::RunSeries(std::size_t n) : n_(n), used_(0), end_(0)
+    { /* */ }
+
+  template <typename T>
+  void RunSeries<T>::Reset(std::size_t n)
+    { n_ = n, used_ = 0, end_ = 0; } // keeps capacity for reuse
+
+  template <typename T>
+  inline void RunSeries<T>::Append(std::size_t length, const T& value) {
+    const std::size_t start = end_;
+    end_ += length;
+    if ( end_ > n_ ) // grows to cover what is appended
+      n_ = end_;
+    if ( length == 0 || (used_ > 0 && values_[used_-1] == value) )
+      return;
+    if ( used_ == starts_.size() )
+      starts_.push_back(start), values_.push_back(value);
+    else
+      starts_[used_] = start, values_[used_] = value;
+    ++used_;
+  }
+
+  template <typename T>
+  inline T RunSeries<T>::At(std::size_t t) const {
+    const std::size_t* s = &starts_[0];
+    return(values_[static_cast<std::size_t>(std::upper_bound(s, s + used_, t) - s) - 1]);
+  }
+
+  template <typename T>
+  std::size_t RunSeries<T>::Runs() const
+    { return(used_); }
+
+  template <typename T>
+  std::size_t RunSeries<T>::Start(std::size_t r) const
+    { return(starts_[r]); }
+
+  template <typename T>
+  std::size_t RunSeries<T>::Length(std::size_t r) const
+    { return(((r + 1 < used_) ? starts_[r+1] : n_) - starts_[r]); }
+
+  template <typename T>
+  const T& RunSeries<T>::Value(std::size_t r) const
+    { return(values_[r]); }
+
+  template <typename T>
+  std::size_t RunSeries<T>::size() const
+    { return(n_); }
+
+
+  //==============
+  // encode_runs()
+  //==============
+  template <typename Sequence>
+  RunSeries<typename Sequence::value_type> encode_runs(const Sequence& X) {
+    const std::size_t N = static_cast<std::size_t>(X.size());
+    RunSeries<typename Sequence::value_type> runs(N);
+    for ( std::size_t t = 0, s = 0; t < N; s = t ) {
+      while ( ++t < N && X[t] == X[s] );
+      runs.Append(t - s, X[s]);
+    } // for
+    return(runs);
+  }
+
+
+  //===============
+  // reflect_runs()
+  //===============
+  template <typename T>
+  RunSeries<T> reflect_runs(const RunSeries<T>& X) {
+    RunSeries<T> runs(2 * X.size());
+    for ( std::size_t r = 0; r < X.Runs(); ++r )
+      runs.Append(X.Length(r), X.Value(r));
+    for ( std::size_t r = X.Runs(); r > 0; --r )
+      runs.Append(X.Length(r-1), X.Value(r-1));
+    return(runs);
+  }
+
+
+  //==========
+  // SaveRuns
+  //==========
+
+  template <typename T>
+  SaveRuns<T>::SaveRuns(std::size_t n, int pLevel) : n_(n), pLevel_(pLevel), current_(0)
+    { /* */ }
+
+  template <typename T>
+  void SaveRuns<T>::Level(int level) {
+    current_ = 0;
+    if ( pLevel_ >= 0 && level != pLevel_ )
+      return;
+    current_ = &levels_[level];
+    current_->Reset(n_);
+  }
+
+  template <typename T>
+  inline void SaveRuns<T>::operator()(std::size_t start, std::size_t length, const T& t) {
+    if ( current_ )
+      current_->Append(length, t);
+  }
+
+  template <typename T>
+  const std::map< int, RunSeries<T> >& SaveRuns<T>::Levels() const
+    { return(levels_); }
+
+
+  namespace Details {
+
+    //============
+    // RunScratch : reused by every runs_step() of a transform
+    //============
+    template <typename T>
+    struct RunScratch {
+      std::vector<std::size_t> cuts_;
+      std::vector<T> dense_;
+    };
+
+    //=============
+    // runs_step() : one forward (modwt_forward()) or backward (zero-phase) filter step
+    //=============
+    // o scratch.cuts_ gets the only positions where 'out' may change
+    // o once runs are too short for that to pay off, the step is done densely
+    //=============
+    template <typename T, typename Filter>
+    void runs_step(const RunSeries<T>& in, const Filter& filt, int j, bool forward,
+                   RunSeries<T>& out, RunScratch<T>& scratch) {
+
+      const std::size_t N = in.size();
+      const std::size_t L = static_cast<std::size_t>(filt.size());
+      const std::size_t D = static_cast<std::size_t>(std::pow(2.0, j)) % N;
+      std::vector<std::size_t>& cuts = scratch.cuts_;
+
+      out.Reset(N);
+      if ( in.Runs() * L > N / 4 ) {
+        std::vector<T>& X = scratch.dense_;
+        X.resize(N);
+        for ( std::size_t r = 0; r < in.Runs(); ++r )
+          std::fill(X.begin() + in.Start(r), X.begin() + in.Start(r) + in.Length(r), in.Value(r));
+        for ( std::size_t t = 0; t < N; ++t ) {
+          T v = filt[0] * X[t];
+          for ( std::size_t l = 1, k = t; l < L; ++l ) {
+            k = forward ? ((k >= D) ? k - D : N + k - D) : ((k + D) % N);
+            v += filt[l] * X[k];
+          } // for
+          out.Append(1, v);
+        } // for
+        return;
+      }
+
+      cuts.clear();
+      for ( std::size_t r = 0; r < in.Runs(); ++r ) {
+        for ( std::size_t l = 0, off = 0; l < L; ++l, off = (off + D) % N )
+          cuts.push_back(forward ? (in.Start(r) + off) % N : (in.Start(r) + N - off) % N);
+      } // for
+      std::sort(cuts.begin(), cuts.end());
+      cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+      // tap l reads position t -/+ l*D, which only moves forward with t until
+      //  it wraps ; one run cursor per tap avoids searching
+      std::vector<std::size_t> cursor(L, 0);
+      const std::size_t R = in.Runs();
+      for ( std::size_t c = 0; c < cuts.size(); ++c ) {
+        const std::size_t t = cuts[c];
+        T v = 0;
+        for ( std::size_t l = 0, k = t; l < L; ++l ) {
+          if ( l > 0 )
+            k = forward ? ((k >= D) ? k - D : N + k - D) : ((k + D) % N);
+          std::size_t& r = cursor[l];
+          if ( in.Start(r) > k ) // wrapped around
+            r = 0;
+          while ( r + 1 < R && in.Start(r + 1) <= k )
+            ++r;
+          if ( l == 0 )
+            v = filt[0] * in.Value(r);
+          else
+            v += filt[l] * in.Value(r);
+        } // for
+        out.Append(((c + 1 < cuts.size()) ? cuts[c+1] : N) - t, v);
+      } // for
+    }
+
+    //=============
+    // runs_emit()
+    //=============
+    template <typename T, typename Op>
+    void runs_emit(const RunSeries<T>& X, int level, Op& op) {
+      op.Level(level);
+      for ( std::size_t r = 0; r < X.Runs(); ++r )
+        op(X.Start(r), X.Length(r), X.Value(r));
+    }
+
+    //===============
+    // runs_checks()
+    //===============
+    template <typename T>
+    void runs_checks(const RunSeries<T>& X, int numLevels, const char* who) {
+      Ext::Assert<Ext::ArgumentError>(X.Runs() > 0 && numLevels > 0, who, "empty input or level");
+      double expsz = numLevels - 1;
+      Ext::Assert<Ext::ArgumentError>(X.size() >= std::pow(2.0, expsz), who, "wavelet xfm exceeds sample size");
+    }
+
+  } // namespace Details
+
+
+  //=============
+  // modwt_runs()
+  //=============
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename VOp,
+            typename WOp
+           >
+  void modwt_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                  int numLevels, VOp& vop, WOp& wop) {
+
+    Details::runs_checks(X, numLevels, "modwt_runs()");
+    RunSeries<T> Vi(X), Vj, Wj;
+    Details::RunScratch<T> cuts;
+    for ( int j = 0; j < numLevels; ++j ) {
+      Details::runs_step(Vi, wavefilt, j, true, Wj, cuts);
+      Details::runs_step(Vi, scalefilt, j, true, Vj, cuts);
+      vop.Level(j+1);
+      wop.Level(j+1);
+      for ( std::size_t r = 0; r < Vj.Runs(); ++r )
+        vop(Vj.Start(r), Vj.Length(r), Vj.Value(r));
+      for ( std::size_t r = 0; r < Wj.Runs(); ++r )
+        wop(Wj.Start(r), Wj.Length(r), Wj.Value(r));
+      std::swap(Vi, Vj);
+    } // for
+  }
+
+
+  //==============
+  // smooth_runs()
+  //==============
+  template <
+            typename T,
+            typename ScalingFilter,
+            typename SmoothOp
+           >
+  void smooth_runs(const RunSeries<T>& X, const ScalingFilter& scalefilt, int numLevels, SmoothOp& sop) {
+
+    Details::runs_checks(X, numLevels, "smooth_runs()");
+    RunSeries<T> Ki(X), Kj;
+    Details::RunScratch<T> cuts;
+    for ( int j = 0; j < numLevels; ++j ) { // V_J
+      Details::runs_step(Ki, scalefilt, j, true, Kj, cuts);
+      std::swap(Ki, Kj);
+    } // for
+    for ( int j = numLevels - 1; j >= 0; --j ) { // as smooth() does
+      Details::runs_step(Ki, scalefilt, j, false, Kj, cuts);
+      std::swap(Ki, Kj);
+    } // for
+    Details::runs_emit(Ki, numLevels, sop);
+  }
+
+
+  //===============
+  // details_runs()
+  //===============
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailsOp
+           >
+  void details_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                    int numLevels, DetailsOp& dop) {
+
+    Details::runs_checks(X, numLevels, "details_runs()");
+    RunSeries<T> Vi(X), Vj, Ki, Kj;
+    Details::RunScratch<T> cuts;
+    for ( int level = 0; level < numLevels; ++level ) {
+      Details::runs_step(Vi, wavefilt, level, true, Ki, cuts); // W_{level+1}
+      for ( int j = 0; j < level; ++j ) { // as details_one() does
+        Details::runs_step(Ki, scalefilt, j, false, Kj, cuts);
+        std::swap(Ki, Kj);
+      } // for
+      Details::runs_step(Ki, wavefilt, level, false, Kj, cuts);
+      std::swap(Ki, Kj);
+      Details::runs_emit(Ki, level + 1, dop);
+
+      if ( level + 1 < numLevels ) {
+        Details::runs_step(Vi, scalefilt, level, true, Vj, cuts);
+        std::swap(Vi, Vj);
+      }
+    } // for
+  }
+
+
+  //===========
+  // mra_runs()
+  //===========
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailsOp,
+            typename SmoothOp
+           >
+  void mra_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                int numLevels, DetailsOp& dop, SmoothOp& sop) {
+    details_runs(X, wavefilt, scalefilt, numLevels, dop);
+    smooth_runs(X, scalefilt, numLevels, sop);
+  }
+
+} // namespace WT
@@ -0,0 +1,169 @@
+/*
+  FILE: WTRuns.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 17:14:36 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_RUNS_FRAMEWORK_HPP
+#define WT_RUNS_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "Wavelet.hpp"
+
+namespace WT {
+
+  //===========
+  // RunSeries : a periodic series of N values kept as runs of equal values
+  //===========
+  /*
+    Run r covers positions [Start(r), Start(r) + Length(r)) ; runs are in
+    order, cover [0, N) and neighbors never share a value.  N grows as needed
+    to cover the runs Append()ed.
+  */
+  template <typename T>
+  struct RunSeries {
+    typedef T value_type;
+
+    explicit RunSeries(std::size_t n = 0);
+
+    void Append(std::size_t length, const T& value); // merges with the last run when equal
+    void Reset(std::size_t n); // no runs, size n
+
+    T At(std::size_t t) const; // O(log Runs())
+    std::size_t Runs() const;
+    std::size_t Start(std::size_t r) const;
+    std::size_t Length(std::size_t r) const;
+    const T& Value(std::size_t r) const;
+    std::size_t size() const;
+
+  private:
+    std::size_t n_, used_, end_;
+    std::vector<std::size_t> starts_;
+    std::vector<T> values_;
+  };
+
+  //==============
+  // encode_runs() : RunSeries of a Sequence
+  //==============
+  template <typename Sequence>
+  RunSeries<typename Sequence::value_type> encode_runs(const Sequence& X);
+
+  //===============
+  // reflect_runs() : X followed by X in reverse ; the reflected boundary
+  //===============
+  template <typename T>
+  RunSeries<T> reflect_runs(const RunSeries<T>& X);
+
+
+  //==========
+  // SaveRuns : op that keeps the runs of every level it is given, like SaveAllValues
+  //==========
+  // o 'n' is the size of the transformed series
+  // o with pLevel >= 0, only that level is kept
+  //==========
+  template <typename T>
+  struct SaveRuns : public DoNothing {
+    explicit SaveRuns(std::size_t n, int pLevel = -1);
+
+    void Level(int level);
+    inline void operator()(std::size_t start, std::size_t length, const T& t);
+    const std::map< int, RunSeries<T> >& Levels() const;
+
+  private:
+    std::size_t n_;
+    int pLevel_;
+    std::map< int, RunSeries<T> > levels_;
+    RunSeries<T>* current_;
+  };
+
+
+  /* The run-length engine.  A level's filter at t reads t, t -/+ D, ..., so
+      where all L of those positions fall within runs, its output holds still.
+      Output can only change L*D positions around an input change, and only
+      those pieces are computed, each once: the work follows the number of
+      runs rather than N.  A constant stretch longer than a level's filter
+      support stays a single run, where the wavelet coefficients vanish and
+      the scaling coefficients equal the constant.  Values are the same as
+      those of the dense functions, summed in the same order.
+     Ops get Level(j) as usual, then op(start, length, value) once per run.
+      PrintRuns in WTOps.hpp writes them out.
+  */
+
+  //=============
+  // modwt_runs() : modwt() of a RunSeries
+  //=============
+  template <
+            typename T,
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp (MODWT)
+            typename VOp,           // Op called for each run of scaling coefficients
+            typename WOp            // Op called for each run of wavelet coefficients
+           >
+  void modwt_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                  int numLevels, VOp& vop, WOp& wop);
+
+
+  //==============
+  // smooth_runs() : the level 'numLevels' smooth of a RunSeries ; sop.Level(numLevels) then its runs
+  //==============
+  template <
+            typename T,
+            typename ScalingFilter,
+            typename SmoothOp
+           >
+  void smooth_runs(const RunSeries<T>& X, const ScalingFilter& scalefilt, int numLevels, SmoothOp& sop);
+
+
+  //===============
+  // details_runs() : the details of a RunSeries ; dop.Level(j) then the runs of detail j, j = 1..numLevels
+  //===============
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailsOp
+           >
+  void details_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                    int numLevels, DetailsOp& dop);
+
+
+  //===========
+  // mra_runs() : details_runs() followed by smooth_runs()
+  //===========
+  template <
+            typename T,
+            typename WaveletFilter,
+            typename ScalingFilter,
+            typename DetailsOp,
+            typename SmoothOp
+           >
+  void mra_runs(const RunSeries<T>& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt,
+                int numLevels, DetailsOp& dop, SmoothOp& sop);
+
+} // namespace WT
+
+#include "WTRuns.cpp"
+
+#endif // WT_RUNS_FRAMEWORK_HPP
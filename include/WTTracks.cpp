@@ -0,0 +1,210 @@
+/*
+  FILE: WTTracks.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 18:02:44 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Assertion.hpp"
+#include "Exception.hpp"
+#include "PrintTypes.hpp"
+#include "WTTracks.hpp"
+
+
+namespace WT {
+
+  namespace Details {
+
+    //==============
+    // TrackBuilder : adds [start, end) = value to the right Track, filling gaps with zeros
+    //==============
+    template <typename T>
+    struct TrackBuilder {
+      explicit TrackBuilder(std::vector< Track<T> >& tracks) : tracks_(tracks), end_(0)
+        { tracks_.clear(); }
+
+      void Add(const std::string& chrom, unsigned long long start, unsigned long long end, T value) {
+        Ext::Assert<Ext::DataError>(end > start, "Empty or backward interval on " + chrom);
+        if ( tracks_.empty() || tracks_.back().name_ != chrom ) {
+          Ext::Assert<Ext::DataError>(seen_.insert(chrom).second,
+                                      "Input must keep each chromosome together: " + chrom);
+          tracks_.push_back(Track<T>());
+          tracks_.back().name_ = chrom;
+          tracks_.back().first_ = start;
+          end_ = start;
+        }
+        Ext::Assert<Ext::DataError>(start >= end_, "Input must be sorted without overlaps on " + chrom);
+        RunSeries<T>& runs = tracks_.back().values_;
+        if ( start > end_ ) // a gap ; never materialized
+          runs.Append(static_cast<std::size_t>(start - end_), T(0));
+        runs.Append(static_cast<std::size_t>(end - start), value);
+        end_ = end;
+      }
+
+    private:
+      std::vector< Track<T> >& tracks_;
+      std::set<std::string> seen_;
+      unsigned long long end_;
+    };
+
+    //==============
+    // track_skip() : true for blank, comment, track and browser lines
+    //==============
+    inline bool track_skip(const char*& p) {
+      while ( *p && std::isspace(static_cast<unsigned char>(*p)) )
+        ++p;
+      return(*p == '\0' || *p == '#' || 0 == std::strncmp(p, "track", 5) || 0 == std::strncmp(p, "browser", 7));
+    }
+
+    //===============
+    // track_field() : value of key=value in a WIG declaration line ; empty if absent
+    //===============
+    inline std::string track_field(const char* line, const char* key) {
+      const char* p = std::strstr(line, key);
+      if ( !p )
+        return("");
+      p += std::strlen(key);
+      const char* e = p;
+      while ( *e && !std::isspace(static_cast<unsigned char>(*e)) )
+        ++e;
+      return(std::string(p, e));
+    }
+
+    //=============
+    // track_num() : the next number on the line, or a DataError
+    //=============
+    inline double track_num(char*& p, const char* line) {
+      char* end = 0;
+      const double d = std::strtod(p, &end);
+      Ext::Assert<Ext::DataError>(end != p, "Unable to read track input", line);
+      p = end;
+      return(d);
+    }
+
+  } // namespace Details
+
+
+  //================
+  // readBedGraph()
+  //================
+  template <typename T>
+  void readBedGraph(FILE* in, std::vector< Track<T> >& tracks) {
+    Details::TrackBuilder<T> builder(tracks);
+    char* line = 0;
+    std::size_t lineSz = 0;
+    try {
+      while ( ::getline(&line, &lineSz, in) > 0 ) {
+        const char* q = line;
+        if ( Details::track_skip(q) )
+          continue;
+        char* p = const_cast<char*>(q);
+        while ( *p && !std::isspace(static_cast<unsigned char>(*p)) )
+          ++p;
+        const std::string chrom(q, static_cast<std::size_t>(p - q));
+        const double start = Details::track_num(p, line), end = Details::track_num(p, line);
+        const T value = static_cast<T>(Details::track_num(p, line));
+        Ext::Assert<Ext::DataError>(start >= 0, "Negative coordinate", line);
+        builder.Add(chrom, static_cast<unsigned long long>(start), static_cast<unsigned long long>(end), value);
+      } // while
+    } catch(...) {
+      std::free(line);
+      throw;
+    }
+    std::free(line);
+    Ext::Assert<Ext::DataError>(!tracks.empty(), "Empty bedGraph input");
+  }
+
+
+  //===========
+  // readWig()
+  //===========
+  template <typename T>
+  void readWig(FILE* in, std::vector< Track<T> >& tracks) {
+    Details::TrackBuilder<T> builder(tracks);
+    enum { NONE, FIXED, VARIABLE } mode = NONE;
+    std::string chrom;
+    unsigned long long pos = 0, step = 1, span = 1;
+    char* line = 0;
+    std::size_t lineSz = 0;
+    try {
+      while ( ::getline(&line, &lineSz, in) > 0 ) {
+        const char* q = line;
+        if ( Details::track_skip(q) )
+          continue;
+        const bool fixed = (0 == std::strncmp(q, "fixedStep", 9));
+        if ( fixed || 0 == std::strncmp(q, "variableStep", 12) ) {
+          mode = fixed ? FIXED : VARIABLE;
+          chrom = Details::track_field(q, "chrom=");
+          Ext::Assert<Ext::DataError>(!chrom.empty(), "WIG declaration without chrom=", line);
+          const std::string st = Details::track_field(q, "start="), sp = Details::track_field(q, "span=");
+          const std::string stp = Details::track_field(q, "step=");
+          Ext::Assert<Ext::DataError>(!fixed || !st.empty(), "fixedStep without start=", line);
+          pos = fixed ? std::strtoull(st.c_str(), 0, 10) : 1; // 1-based in the file
+          Ext::Assert<Ext::DataError>(pos >= 1, "WIG start= must be 1 or more", line);
+          --pos;
+          span = sp.empty() ? 1 : std::strtoull(sp.c_str(), 0, 10);
+          step = stp.empty() ? 1 : std::strtoull(stp.c_str(), 0, 10);
+          continue;
+        }
+
+        Ext::Assert<Ext::DataError>(mode != NONE, "WIG data before any fixedStep or variableStep line", line);
+        char* p = const_cast<char*>(q);
+        if ( mode == VARIABLE ) {
+          const double at = Details::track_num(p, line);
+          Ext::Assert<Ext::DataError>(at >= 1, "WIG positions start at 1", line);
+          pos = static_cast<unsigned long long>(at) - 1;
+        }
+        const T value = static_cast<T>(Details::track_num(p, line));
+        builder.Add(chrom, pos, pos + span, value);
+        if ( mode == FIXED )
+          pos += step;
+      } // while
+    } catch(...) {
+      std::free(line);
+      throw;
+    }
+    std::free(line);
+    Ext::Assert<Ext::DataError>(!tracks.empty(), "Empty WIG input");
+  }
+
+
+  //=================
+  // writeBedGraph()
+  //=================
+  template <typename T>
+  void writeBedGraph(FILE* out, const Track<T>& track, const RunSeries<T>& runs, std::size_t limit) {
+    for ( std::size_t r = 0; r < runs.Runs() && runs.Start(r) < limit; ++r ) {
+      const std::size_t end = std::min(runs.Start(r) + runs.Length(r), limit);
+      std::fprintf(out, "%s\t%llu\t%llu\t", track.name_.c_str(), track.first_ + runs.Start(r), track.first_ + end);
+      PrintTypes::Println(out, runs.Value(r));
+    } // for
+  }
+
+} // namespace WT
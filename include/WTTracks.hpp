@@ -0,0 +1,82 @@
+/*
+  FILE: WTTracks.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 18:02:44 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+
+#ifndef WT_TRACKS_FRAMEWORK_HPP
+#define WT_TRACKS_FRAMEWORK_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "WTRuns.hpp"
+
+namespace WT {
+
+  //=======
+  // Track : one sequence (chromosome) of a bedGraph or WIG file, as runs
+  //=======
+  /*
+    Position 0 of values_ is coordinate first_ (0-based, as bedGraph).
+    Stretches the file does not cover become runs of zeros, so gaps cost one
+    run each no matter how long they are.
+  */
+  template <typename T>
+  struct Track {
+    std::string name_;
+    unsigned long long first_;
+    RunSeries<T> values_;
+  };
+
+
+  //================
+  // readBedGraph() : 'chrom start end value' lines ; one Track per chromosome
+  //================
+  // o track, browser and # lines are skipped
+  // o each chromosome's lines must be together and sorted, without overlaps
+  //================
+  template <typename T>
+  void readBedGraph(FILE* in, std::vector< Track<T> >& tracks);
+
+
+  //===========
+  // readWig() : fixedStep and variableStep sections ; one Track per chromosome
+  //===========
+  // o as for readBedGraph(), a chromosome's sections must be together and in order
+  //===========
+  template <typename T>
+  void readWig(FILE* in, std::vector< Track<T> >& tracks);
+
+
+  //=================
+  // writeBedGraph() : 'runs' of a Track's transform, clipped to 'limit' positions
+  //=================
+  template <typename T>
+  void writeBedGraph(FILE* out, const Track<T>& track, const RunSeries<T>& runs, std::size_t limit);
+
+} // namespace WT
+
+#include "WTTracks.cpp"
+
+#endif // WT_TRACKS_FRAMEWORK_HPP
@@ -0,0 +1,242 @@
+/*
+  FILE: WTWriter.cpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 09:12:40 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "Formats.hpp"
+#include "SPSCQueue.hpp"
+#include "WTOutput.hpp"
+#include "WTWriter.hpp"
+
+
+namespace WT {
+
+  //=============
+  // BlockWriter
+  //=============
+
+  BlockWriter::BlockWriter(std::size_t blockValues, std::size_t numBlocks, std::size_t columns)
+      : blockValues_(blockValues), columns_(columns > 0 ? columns : 1), binary_(writerOptions().binary_),
+        work_(numBlocks + 1), free_(numBlocks + 1), current_(0), backend_(makeBackend(writerOptions())),
+        out_(0), fd_(-1), offset_(0), buf_(0), bufId_(0), used_(0), column_(0) {
+
+    for ( std::size_t i = 0; i < numBlocks; ++i ) {
+      all_.push_back(new Details::OutputBlock);
+      free_.Push(all_.back());
+    } // for
+    thread_ = std::thread(&BlockWriter::run, this);
+  }
+
+  Details::OutputBlock* BlockWriter::acquire() {
+    Details::OutputBlock* blk = 0;
+    free_.Pop(blk); // waits on the writer thread when every block is in flight
+    blk->kind_ = Details::OutputBlock::DATA;
+    blk->fptr_ = 0;
+    blk->print_ = 0;
+    blk->count_ = 0;
+    blk->bytes_.clear();
+    return(blk);
+  }
+
+  void BlockWriter::submit(Details::OutputBlock* blk)
+    { work_.Push(blk); }
+
+  void BlockWriter::Open(FILE* fptr) {
+    if ( current_ )
+      submit(current_), current_ = 0;
+    Details::OutputBlock* blk = acquire();
+    blk->kind_ = Details::OutputBlock::OPEN;
+    blk->fptr_ = fptr;
+    submit(blk);
+  }
+
+  void BlockWriter::Close(FILE* fptr) {
+    if ( current_ )
+      submit(current_), current_ = 0;
+    Details::OutputBlock* blk = acquire();
+    blk->kind_ = Details::OutputBlock::CLOSE;
+    blk->fptr_ = fptr;
+    submit(blk);
+  }
+
+  template <typename T>
+  inline void BlockWriter::Put(const T& t) {
+    static_assert(std::is_arithmetic<T>::value, "BlockWriter requires arithmetic values");
+    Details::OutputBlock::Printer p = binary_ ? &BlockWriter::copyBlock<T> : &BlockWriter::printBlock<T>;
+    if ( current_ && current_->print_ != p ) // value type changed mid-block
+      submit(current_), current_ = 0;
+    if ( !current_ ) {
+      current_ = acquire();
+      current_->print_ = p;
+      current_->bytes_.reserve(blockValues_ * sizeof(T));
+    }
+
+    const std::size_t sz = current_->bytes_.size();
+    current_->bytes_.resize(sz + sizeof(T));
+    std::memcpy(&current_->bytes_[sz], &t, sizeof(T));
+    if ( ++current_->count_ == blockValues_ )
+      submit(current_), current_ = 0;
+  }
+
+  template <typename T>
+  void BlockWriter::printBlock(BlockWriter& w, const char* bytes, std::size_t count) {
+    T t;
+    for ( std::size_t i = 0; i < count; ++i, bytes += sizeof(T) ) {
+      std::memcpy(&t, bytes, sizeof(T));
+      w.format(t);
+    } // for
+  }
+
+  template <typename T>
+  void BlockWriter::copyBlock(BlockWriter& w, const char* bytes, std::size_t count)
+    { w.append(bytes, count * sizeof(T)); }
+
+  template <typename T>
+  inline void BlockWriter::format(const T& t) {
+    // same output as PrintTypes::Println() ; tabs between the columns of a row
+    static const std::string end = Formats::Format(t) + std::string("\n");
+    static const std::string tab = Formats::Format(t) + std::string("\t");
+    if ( ++column_ == columns_ )
+      column_ = 0;
+    const char* fmt = (column_ == 0) ? end.c_str() : tab.c_str();
+    const std::size_t cap = backend_->BufferBytes();
+    while ( true ) {
+      const std::size_t room = cap - used_;
+      const int n = std::snprintf(buf_ + used_, room, fmt, t);
+      if ( n < 0 )
+        return;
+      if ( static_cast<std::size_t>(n) < room ) {
+        used_ += static_cast<std::size_t>(n);
+        return;
+      }
+      if ( used_ == 0 ) { // longer than a whole buffer ; keep what fit
+        used_ = cap - 1;
+        return;
+      }
+      flush();
+    } // while
+  }
+
+  void BlockWriter::append(const char* bytes, std::size_t sz) {
+    const std::size_t cap = backend_->BufferBytes();
+    while ( sz > 0 ) {
+      std::size_t n = cap - used_;
+      if ( n > sz )
+        n = sz;
+      std::memcpy(buf_ + used_, bytes, n);
+      used_ += n, bytes += n, sz -= n;
+      if ( used_ == cap )
+        flush();
+    } // while
+  }
+
+  void BlockWriter::flush() {
+    if ( used_ == 0 )
+      return;
+    if ( offset_ < 0 ) // pipe or append-mode: keep it simple and in order
+      WriteBackend::writeAll(fd_, buf_, used_, -1);
+    else {
+      backend_->Write(fd_, bufId_, used_, offset_);
+      offset_ += static_cast<long long>(used_);
+      buf_ = backend_->Acquire(bufId_);
+    }
+    used_ = 0;
+  }
+
+  void BlockWriter::openFile(FILE* fptr) {
+    if ( out_ ) // reopened without a Close() (stdout) ; finish what we have
+      flush(), backend_->Drain();
+    out_ = fptr;
+    fd_ = fileno(fptr);
+    std::fflush(fptr); // in case anything was written through stdio before
+    const off_t pos = ::lseek(fd_, 0, SEEK_CUR);
+    const int flags = ::fcntl(fd_, F_GETFL);
+    offset_ = (pos < 0 || flags < 0 || (flags & O_APPEND)) ? -1 : static_cast<long long>(pos);
+    if ( !buf_ )
+      buf_ = backend_->Acquire(bufId_);
+    used_ = 0;
+    column_ = 0;
+  }
+
+  void BlockWriter::closeFile(FILE* fptr) {
+    if ( fptr == out_ ) {
+      flush();
+      backend_->Drain();
+      if ( offset_ >= 0 ) // leave the descriptor where stdio expects it
+        ::lseek(fd_, static_cast<off_t>(offset_), SEEK_SET);
+      out_ = 0;
+    }
+    if ( fptr == stdout )
+      std::fflush(stdout);
+    else if ( fptr )
+      std::fclose(fptr);
+  }
+
+  void BlockWriter::run() {
+    Details::OutputBlock* blk = 0;
+    while ( true ) {
+      work_.Pop(blk);
+      switch ( blk->kind_ ) {
+        case Details::OutputBlock::OPEN:
+          openFile(blk->fptr_);
+          break;
+        case Details::OutputBlock::CLOSE:
+          closeFile(blk->fptr_);
+          break;
+        case Details::OutputBlock::STOP:
+          if ( out_ )
+            flush(), backend_->Drain();
+          free_.Push(blk);
+          return;
+        default: // DATA
+          if ( out_ )
+            blk->print_(*this, &blk->bytes_[0], blk->count_);
+      };
+      free_.Push(blk);
+    } // while
+  }
+
+  BlockWriter::~BlockWriter() {
+    if ( current_ )
+      submit(current_), current_ = 0;
+    Details::OutputBlock* blk = acquire();
+    blk->kind_ = Details::OutputBlock::STOP;
+    submit(blk);
+    thread_.join();
+    backend_.reset(); // waits on any outstanding writes
+    for ( std::size_t i = 0; i < all_.size(); ++i )
+      delete all_[i];
+  }
+
+} // namespace WT
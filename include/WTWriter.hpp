@@ -0,0 +1,135 @@
+/*
+  FILE: WTWriter.hpp
+  AUTHOR: Shane Neph & Scott Kuehn
+  CREATE DATE: Sun Oct 18 09:12:40 PDT 2026
+*/
+
+//    The Maximal Overlap Discrete Wavelet Transform (MODWT)
+//    Copyright (C) 2007-2013 Shane Neph & Scott Kuehn
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License along
+//    with this program; if not, write to the Free Software Foundation, Inc.,
+//    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+
+#ifndef WT_WRITER_FRAMEWORK_HPP
+#define WT_WRITER_FRAMEWORK_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SPSCQueue.hpp"
+#include "WTOutput.hpp"
+
+namespace WT {
+
+  struct BlockWriter;
+
+  namespace Details {
+
+    //=============
+    // OutputBlock : unit of work passed from a compute thread to a BlockWriter
+    //=============
+    struct OutputBlock {
+      enum Kind { DATA, OPEN, CLOSE, STOP };
+      typedef void (*Printer)(BlockWriter&, const char*, std::size_t);
+
+      OutputBlock() : kind_(DATA), fptr_(0), print_(0), count_(0)
+        { /* */ }
+
+      Kind kind_;
+      FILE* fptr_;
+      Printer print_;
+      std::size_t count_;
+      std::vector<char> bytes_;
+    };
+
+  } // namespace Details
+
+
+  //=============
+  // BlockWriter
+  //=============
+  /*
+    Moves formatting and writing of output values off of the compute thread.
+    Values given to Put() are packed in binary form into fixed-size blocks, and
+    full blocks are handed to a dedicated writer thread through a bounded
+    SPSCQueue.  The writer thread formats each value one per line (or copies
+    it as-is when writerOptions().binary_ is set) into buffers of a
+    WriteBackend, which writes them asynchronously at explicit file offsets.
+    Open() and Close() are queued in order with the data, so the writer
+    thread owns a FILE* from Open() until its matching Close().  Nothing is
+    written through the FILE* itself; it only supplies the descriptor.
+    Pipes and append-mode files are written sequentially by the writer thread.
+    With columns > 1, text output has that many values per line, separated by
+    tabs, so several series can share one file; binary output is unaffected.
+    Only a fixed number of blocks ever exist.  When all of them are in flight,
+    Put() waits for the writer thread to return one, which bounds memory use
+    when computation outpaces the disk.
+    Exactly one thread may call Put(), Open() and Close() on a given object.
+  */
+  struct BlockWriter {
+    explicit BlockWriter(std::size_t blockValues = 8192, std::size_t numBlocks = 8, std::size_t columns = 1);
+
+    void Open(FILE* fptr);
+    void Close(FILE* fptr);
+    template <typename T>
+    inline void Put(const T& t);
+    ~BlockWriter();
+
+  private:
+    BlockWriter(const BlockWriter&); // not copyable
+    BlockWriter& operator=(const BlockWriter&);
+
+    Details::OutputBlock* acquire();
+    void submit(Details::OutputBlock* blk);
+    void run();
+
+    // writer thread only
+    void openFile(FILE* fptr);
+    void closeFile(FILE* fptr);
+    void append(const char* bytes, std::size_t sz);
+    void flush();
+
+    template <typename T>
+    inline void format(const T& t);
+
+    template <typename T>
+    static void printBlock(BlockWriter& w, const char* bytes, std::size_t count);
+
+    template <typename T>
+    static void copyBlock(BlockWriter& w, const char* bytes, std::size_t count);
+
+  private:
+    const std::size_t blockValues_, columns_;
+    const bool binary_;
+    std::vector<Details::OutputBlock*> all_;
+    Ext::SPSCQueue<Details::OutputBlock*> work_, free_;
+    Details::OutputBlock* current_;
+    std::unique_ptr<WriteBackend> backend_;
+    FILE* out_;
+    int fd_;
+    long long offset_; // < 0 -> sequential output
+    char* buf_;
+    std::size_t bufId_, used_, column_;
+    std::thread thread_;
+  };
+
+} // namespace WT
+
+#include "WTWriter.cpp"
+
+#endif // WT_WRITER_FRAMEWORK_HPP
@@ -25,8 +25,11 @@
 #ifndef WT_FRAMEWORK_HPP
 #define WT_FRAMEWORK_HPP
 
+#include <vector>
+
 #include "WTBoundaries.hpp"
 #include "WTFilter.hpp"
+#include "WTHaar.hpp"
 #include "WTOps.hpp"
 
 
@@ -54,12 +57,70 @@ namespace WT {
              VOp& vop, WOp& wop);
 
 
+  //=========
+  // modwt() : overload taking a filter type rather than the filters themselves
+  //=========
+  // o Filter::Haar is computed by haar_modwt() from prefix sums with no cascade
+  // o all other filter types are passed on to modwt() above
+  //=========
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename VOp,           // Op called for each scaling coeff calculated (N per level)
+            typename WOp            // Op called for each wavelet coeff calculated (N per level)
+           >
+  void modwt(Sequence& X, Filter::FType filterType, int numLevels, VOp& vop, WOp& wop);
+
+
+  //===============
+  // modwt_sweep() : modwt() of one series with several filters, sharing the reads of 'X'
+  //===============
+  // o vops[f] and wops[f] get exactly what modwt(X, filterTypes[f], ...) would give them
+  // o level 1 of every filter comes from a single pass over 'X' ; each filter's
+  //    cascade then carries on alone from its own level 1 scaling coefficients
+  // o 'X' is not modified, unlike modwt()
+  //===============
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename ContVOps,      // Container of ops, one per filter, for scaling coeffs
+            typename ContWOps       // Container of ops, one per filter, for wavelet coeffs
+           >
+  void modwt_sweep(const Sequence& X, const std::vector<Filter::FType>& filterTypes, int numLevels,
+                   ContVOps& vops, ContWOps& wops);
+
+
+  //================
+  // modwt_levels() : modwt() giving out wavelet coefficients for chosen levels only
+  //================
+  // o 'levels' lists the levels wanted, each within 1..numLevels
+  // o the scaling cascade runs through 'numLevels' and 'vop' sees every level, as with
+  //    modwt() ; the wavelet filter is only applied at the chosen levels and 'wop'
+  //    sees Level() and values for those alone
+  // o Filter::Haar takes the wanted coefficients straight from prefix sums
+  //================
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp
+            typename VOp,           // Op called for each scaling coeff calculated (N per level)
+            typename WOp            // Op called for each wavelet coeff calculated (N per chosen level)
+           >
+  void modwt_levels(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+                    const std::vector<int>& levels, VOp& vop, WOp& wop);
+
+  template <typename Sequence, typename VOp, typename WOp>
+  void modwt_levels(Sequence& X, Filter::FType filterType, int numLevels,
+                    const std::vector<int>& levels, VOp& vop, WOp& wop);
+
+
   //==========
   // imodwt() : inverse modified discrete wavelet transform
   //==========
   //  o Most often used to invert modwt() results
   //  o 'Wj' should be a vector< vector<T> >, or a deque/array analog or combo
   //  o 'wavefilt' and 'scalefilt' should be the same as those used in the original modwt() call
+  //  o each element of 'Wj' need only be indexable and is only read, so it may be a pointer
+  //     into a larger or mapped buffer
+  //  o 'Vj0' is used as scratch and is overwritten
   //==========
   template <
             typename ScalingCoefficients,     // N scaling coefficients
@@ -68,10 +129,33 @@ namespace WT {
             typename ScalingFilter,           // Same as for modwt()
             typename VOp                      // Op called for each inverse value calculated
            >
-  void imodwt(ScalingCoefficients Vj0, ContWaveletCoefficients& Wj, const WaveletFilter& wavefilt,
+  void imodwt(ScalingCoefficients& Vj0, ContWaveletCoefficients& Wj, const WaveletFilter& wavefilt,
               const ScalingFilter& scalefilt, VOp& vop);
 
 
+  //=================
+  // imodwt_sparse() : imodwt() from a few (level, index, value) coefficients
+  //=================
+  //  o 'Wj' and 'Vj0' hold entries as SparseCoefficients::Entries() gives them: wavelet
+  //     coefficients of levels 1..numLevels and scaling coefficients of level numLevels.
+  //     Every coefficient not listed is zero.
+  //  o 'N' is the length of the transformed series
+  //  o each listed wavelet coefficient is spread over the L values it feeds rather than
+  //     read as part of a full set of N, and levels deeper than the deepest listed
+  //     coefficient are skipped
+  //  o 'vop' is called as with imodwt(): Level(j) then N values, j counting down to 0,
+  //     and the reconstruction comes with Level(0)
+  //=================
+  template <
+            typename SparseEntries, // Container of entries, such as SparseCoefficients<T>::Entry
+            typename WaveletFilter, // Same as for modwt()
+            typename ScalingFilter, // Same as for modwt()
+            typename VOp            // Op called for each inverse value calculated
+           >
+  void imodwt_sparse(const SparseEntries& Vj0, const SparseEntries& Wj, std::size_t N, int numLevels,
+                     const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, VOp& vop);
+
+
 
 
   /* Note that the smooth() and details() calculated below together sum back to the original Sequence X.
@@ -109,6 +193,23 @@ namespace WT {
                const ScalingFilter& scalefilt, ContDetailsOps& dops);
 
 
+  //==================
+  // details_levels() : details() for the wavelet coefficient sets of chosen levels only
+  //==================
+  //  o Wj[i] holds the coefficients of level levels[i], as modwt_levels() gives them,
+  //     and dops[i] is called for its detail waveform
+  //  o only the chosen levels' cascades are run
+  //==================
+  template <
+            typename ContWaveletCoefficients, // Container of containers of N wavelet coeff's
+            typename WaveletFilter,           // Same as for modwt()
+            typename ScalingFilter,           // Same as for modwt()
+            typename ContDetailsOps           // Container of ops, one for each wavelet coeff container
+           >
+  void details_levels(ContWaveletCoefficients& Wj, const std::vector<int>& levels, const WaveletFilter& wavefilt,
+                      const ScalingFilter& scalefilt, ContDetailsOps& dops);
+
+
   //=======
   // mra() : multiresolution analysis ; calculates details and smooth
   //=======
@@ -125,11 +226,54 @@ namespace WT {
            DetailsOp& detailsOp, SmoothOp& smoothOp);
 
 
+  //===========
+  // smooths() : the smooth S_j of every level j = 1..level from one doAll() pass
+  //===========
+  // o S_j = S_{j-1} - D_j with S_0 = 'X', so one running accumulator turns each
+  //    detail, as doAll() finishes it, into the next smooth: O(level) adds per
+  //    value rather than one smooth() cascade per level
+  // o 'sop' receives Level(j) followed by the N values of S_j, for j = 1..level
+  // o 'X' is overwritten
+  //===========
+  template <
+            typename Sequence, // 'X' contains the N original values
+            typename SmoothOp  // Op called for calculated smooth values
+           >
+  void smooths(Sequence& X, unsigned int level, Filter::FType filterType, SmoothOp& sop);
+
+
+  //============
+  // bandpass() : the sum of chosen details, and optionally the smooth, from one inverse cascade
+  //============
+  // o 'levels' lists the details D_j to keep, 1 <= j <= numLevels ; with 'withSmooth'
+  //    the level 'numLevels' smooth is added too
+  // o by linearity this is imodwt() with every other W_j (and V_J) set to zero ;
+  //    zero terms are left out of the cascade rather than multiplied through,
+  //    and without the smooth, levels past the deepest kept detail are never computed
+  // o 'op' sees each inverse step as denoise() gives them: Level() counts backwards
+  //    and the N band-passed values come with Level(numLevels)
+  // o 'X' is overwritten
+  //============
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // Filter from wavelets/WTFilter.hpp
+            typename ScalingFilter, // Filter from wavelets/WTFilter.hpp
+            typename Op             // Op called for each value of each inverse step
+           >
+  void bandpass(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+                const std::vector<int>& levels, bool withSmooth, Op& op);
+
+  template <typename Sequence, typename Op>
+  void bandpass(Sequence& X, Filter::FType filterType, int numLevels,
+                const std::vector<int>& levels, bool withSmooth, Op& op);
+
+
   //=========
   // doAll() : calculates everything from scratch, giving opportunity for all output operations
   //=========
   // o All possible ops available: wavelet coeff's, scaling coeff's, details and smooth
   // o DetailsOp should self-regulate via 'detailsOp.Reset()'.  See struct PrintLast for a good example.
+  // o Filter::Haar coefficients come from Haar::PrefixEngine rather than the cascade
   //=========
   template <
             typename Sequence,              // 'X' contains the N original values
@@ -146,6 +290,63 @@ namespace WT {
              ScalingCoefficientOp& scalingOp,
              SmoothOp& smoothOp);
 
+
+
+  /* The ordinary (decimated) discrete wavelet transform.  Level j keeps only N/2^j
+      wavelet and scaling coefficients, so the whole transform takes O(N) time and
+      fits in 2N values, but it is not shift invariant.  Use filters from
+      getFilters<WT::DWT>(), not getFilters<WT::MODWT>().
+  */
+
+  //=======
+  // dwt() : discrete wavelet transform via the pyramid algorithm
+  //=======
+  // o X.size() must be a multiple of 2^numLevels
+  // o X is overwritten with [V_J | W_J | W_{J-1} | ... | W_1]
+  // o vop and wop are called N/2^j times at level j
+  //=======
+  template <
+            typename Sequence,      // 'X' contains N measurement values
+            typename WaveletFilter, // getFilters<WT::DWT>(...).first
+            typename ScalingFilter, // getFilters<WT::DWT>(...).second
+            typename VOp,           // Op called for each scaling coeff calculated
+            typename WOp            // Op called for each wavelet coeff calculated
+           >
+  void dwt(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+           VOp& vop, WOp& wop);
+
+
+  //========
+  // idwt() : inverse discrete wavelet transform
+  //========
+  // o X must be laid out as dwt() leaves it ; it is overwritten with the
+  //    reconstructed series
+  // o vop is called with the N/2^(j-1) values of V_{j-1}, for j = J..1
+  //========
+  template <
+            typename Sequence,      // dwt() output
+            typename WaveletFilter, // Same as for dwt()
+            typename ScalingFilter, // Same as for dwt()
+            typename VOp            // Op called for each inverse value calculated
+           >
+  void idwt(Sequence& X, const WaveletFilter& wavefilt, const ScalingFilter& scalefilt, int numLevels,
+            VOp& vop);
+
+
+  //===========
+  // dwt_mra() : multiresolution analysis based on dwt() rather than modwt()
+  //===========
+  // o detailsOp is given Level(j) and then the N values of detail j
+  // o smoothOp is given Level(j) for every j, then the N smooth values at the last level
+  //===========
+  template <
+            typename Sequence,  // 'X' contains the N original values ; overwritten
+            typename DetailsOp, // Op called for calculated detail values
+            typename SmoothOp   // Op called for calculated smooth values
+           >
+  void dwt_mra(Sequence& X, unsigned int level, Filter::FType filterType,
+               DetailsOp& detailsOp, SmoothOp& smoothOp);
+
 } // namespace WT
 
 
@@ -22,26 +22,52 @@
 //    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 //
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <sys/stat.h>
+
 #include "Wavelet.hpp"
+#include "WT2D.hpp"
+#include "WTBatch.hpp"
+#include "WTCross.hpp"
+#include "WTDenoise.hpp"
+#include "WTMulti.hpp"
+#include "WTPacket.hpp"
+#include "WTRegion.hpp"
+#include "WTRuns.hpp"
+#include "WTTracks.hpp"
 #include "Assertion.hpp"
+#include "BlockReader.hpp"
 #include "Exception.hpp"
 #include "FPWrap.hpp"
+#include "MappedArray.hpp"
+#include "MappedFile.hpp"
+#include "ParallelFor.hpp"
 
 
 namespace {
 
-  // IMODWT is also available via library API
-  enum Operation { WAVE_COEFFS, SCALE_COEFFS, WAVE_SCALE_COEFFS, SMOOTH, DETAILS, MRA, ALL };
+  enum Operation { WAVE_COEFFS, SCALE_COEFFS, WAVE_SCALE_COEFFS, SMOOTH, DETAILS, MRA, ALL,
+                   DWT_COEFFS, DWT_MRA, PACKETS, VARIANCE, DENOISE, XCORR,
+                   PEAKS, BANDPASS, SMOOTHS, SPARSE, INVERSE, CONTAINER };
 
   struct Help { /* */ };
 
@@ -51,6 +77,9 @@ namespace {
   struct Input {
     Input(int argc, char** argv);
 
+    bool Binary() const
+      { return(binary_); }
+
     std::string BoundaryType() const
       { return(bType_); }
 
@@ -60,42 +89,230 @@ namespace {
     std::string FilterType() const
       { return(fType_); }
 
+    bool FilterGiven() const
+      { return(filterGiven_); }
+
+    const std::vector<std::string>& Filters() const
+      { return(filters_); }
+
+    Input ForFilter(const std::string& filter) const;
+
+    const std::string& InputFormat() const
+      { return(inputFormat_); }
+
+    WT::WriterOptions::Backend IOBackend() const
+      { return(ioBackend_); }
+
+    bool Manifest() const
+      { return(manifest_); }
+
+    bool Matrix() const
+      { return(matrix_); }
+
+    std::size_t MaxLag() const
+      { return(maxLag_); }
+
+    const std::vector<int>& Levels() const
+      { return(levels_); }
+
+    bool LevelsSmooth() const
+      { return(levelsSmooth_); }
+
     int MaxLevel() const
       { return(maxLevel_); }
 
+    double MinMagnitude() const
+      { return(minMagnitude_); }
+
+    const WT::PacketSet& Nodes() const
+      { return(nodes_); }
+
+    std::size_t OutputBin() const
+      { return(outputBin_); }
+
+    bool OutputBinAuto() const
+      { return(binAuto_); }
+
+    WT::PrintValues::Aggregate OutputBinStat() const
+      { return(binStat_); }
+
     Operation Op() const
       { return(op_); }
 
+    double PeakHigh() const
+      { return(peakHigh_); }
+
+    double PeakLow() const
+      { return(peakLow_ < 0 ? peakHigh_ / 2 : peakLow_); }
+
     std::string Prefix() const
       { return(prefix_); }
 
+    std::string Pyramid() const
+      { return(pyramid_); }
+
+    std::size_t RegionFirst() const
+      { return(regionFirst_); }
+
+    std::size_t RegionLast() const
+      { return(regionLast_); }
+
+    int QueueDepth() const
+      { return(queueDepth_); }
+
+    bool Runs() const
+      { return(runs_); }
+
+    std::size_t Threads() const
+      { return(threads_); }
+
+    std::size_t TopK() const
+      { return(topK_); }
+
+    bool TopKGlobal() const
+      { return(topKGlobal_); }
+
+    std::size_t RowBand() const
+      { return(rowBand_); }
+
+    WT::Threshold::Shrink Shrink() const
+      { return(shrink_); }
+
     bool StdOut() const
       { return(toStdout_); }
 
+    WT::Threshold::Rule ThresholdRule() const
+      { return(rule_); }
+
+    const std::vector<std::string>& With() const
+      { return(with_); }
+
+    std::size_t Window() const
+      { return(window_); }
+
+    std::size_t WindowStep() const
+      { return(windowStep_); }
+
     static std::string Usage();
 
     static std::string VerboseUsage();
 
   private:
     std::string lc(const std::string& s);
+    int toPlusInt(const std::string& s);
+    double toPlusNum(const std::string& s);
+    void setIOBackend(const std::string& s);
+    void setFilter(const std::string& s);
     void setLevel(const std::string& s);
+    void setLevels(const std::string& s);
+    void setNodes(const std::string& s);
+    void setOutputBin(const std::string& s);
+    void setOutputBinStat(const std::string& s);
+    void setRegion(const std::string& s);
     void setOperation(const std::string& s);
+    void setWith(const std::string& s);
     static std::string allowedOps();
     static std::string allowedFilters();
     static std::string allowedBoundaries();
 
   private:
     std::string file_, fType_, bType_;
+    bool filterGiven_;
+    std::vector<std::string> filters_;
     Operation op_;
     int maxLevel_;
+    std::string levelsSpec_;
+    std::vector<int> levels_;
+    bool levelsSmooth_;
     bool toStdout_;
     std::string prefix_;
+    bool binary_;
+    WT::WriterOptions::Backend ioBackend_;
+    int queueDepth_;
+    WT::PacketSet nodes_;
+    bool matrix_;
+    std::size_t rowBand_;
+    WT::Threshold::Rule rule_;
+    WT::Threshold::Shrink shrink_;
+    std::vector<std::string> with_;
+    std::size_t maxLag_;
+    std::size_t window_, windowStep_;
+    double peakHigh_, peakLow_;
+    std::size_t outputBin_;
+    bool binAuto_;
+    WT::PrintValues::Aggregate binStat_;
+    std::size_t regionFirst_, regionLast_;
+    std::string pyramid_;
+    bool runs_;
+    std::string inputFormat_;
+    std::size_t threads_;
+    bool manifest_;
+    std::size_t topK_;
+    bool topKGlobal_;
+    double minMagnitude_;
   };
 
 
+  // MODWT wavelet and scaling filters ; as kept by a WT::Workspace
+  typedef std::pair<WT::Filter::WaveletFilter, WT::Filter::ScalingFilter> FilterPair;
+
   // forward decl
-  template <typename X>
-  void useAPI(std::vector<X>&, const Input&, std::size_t);
+  template <typename Sequence>
+  void useAPI(Sequence&, const Input&, std::size_t, const FilterPair* = 0);
+
+  template <typename T>
+  void useMatrixAPI(FILE*, const Input&);
+
+  template <typename T>
+  void useTableAPI(FILE*, const Input&);
+
+  template <typename T>
+  bool parseRow(const char*, std::vector<T>&);
+
+  template <typename Sequence>
+  void useRunsAPI(Sequence&, const Input&, std::size_t, const FilterPair* = 0);
+
+  template <typename Sequence>
+  void useFiltersAPI(Sequence&, const Input&, std::size_t);
+
+  template <typename Sequence>
+  void useSweepAPI(const Sequence&, const Input&, std::size_t);
+
+  template <typename T>
+  void useTracksAPI(FILE*, const Input&);
+
+  template <typename T>
+  void useManifestAPI(FILE*, const Input&, int, char**);
+
+  template <typename T>
+  bool transform(FILE*, const Input&, Ext::MappedArray<T>&, const FilterPair* = 0);
+
+  template <typename T>
+  void useInverseAPI(FILE*, const Input&);
+
+  FilterPair inverseFilters(const Input&, const std::string&, const std::string&);
+
+  bool looksLikeText(const char*, std::size_t);
+
+  void printVariance(const std::vector<WT::WaveletVariance::Estimate>&, const std::string&);
+
+  void printVariances(const std::vector<std::string>&, std::vector<WT::WaveletVariance>&, const std::string&);
+
+  void writeVariance(FILE*, const std::vector<WT::WaveletVariance::Estimate>&, const std::string&);
+
+  void printPeaks(WT::DetectPeaks&, WT::DetectPeaks&, const std::string&);
+
+  template <typename Entries>
+  void printSparse(const Entries&, const Entries&, std::size_t, const std::string&, const std::string&);
+
+  template <typename T>
+  bool readSeries(FILE*, Ext::MappedArray<T>&);
+
+  template <typename T>
+  void reflect(Ext::MappedArray<T>&);
+
+  template <typename Sequence, typename Filter1, typename Filter2>
+  void crossCorrelate(Sequence&, const Input&, std::size_t, const Filter1&, const Filter2&);
 
 } // unnamed namespace
 
@@ -114,30 +331,41 @@ int main(int argc, char** argv)
     Input input(argc, argv);
     Ext::FPWrap<Ext::InvalidFile> infile(input.File());
 
-    // Read in all data
-    std::vector<T> x; // our original series
-    T d;
-    std::string f = Formats::Format(T()) + std::string("\n");
-    char const* format = f.c_str();
-    while ( !std::feof(infile) ) { // read the whole file
-      if ( EOF == std::fscanf(infile, format, &d) ) {
-        std::fprintf(stderr, "Unable to read numeric input");
-        return(EXIT_FAILURE);
-      }
-      x.push_back(d);
-    } // while
+    // Output settings used by every print op
+    WT::writerOptions().binary_ = input.Binary();
+    WT::writerOptions().backend_ = input.IOBackend();
+    WT::writerOptions().queueDepth_ = static_cast<std::size_t>(input.QueueDepth());
 
-    // Deal with possible reflected boundary
-    std::size_t outputSize = x.size();
-    WT::Boundary boundaryType = WT::selectBoundary(input.BoundaryType());
-    if ( boundaryType == WT::Reflected ) {
-      x.resize(2 * outputSize);
-      for ( std::size_t i = 2 * outputSize - 1, j = 0; i >= outputSize; )
-        x[i--] = x[j++];
+    if ( input.Op() == INVERSE ) { // coefficient files back to a series
+      useInverseAPI<T>(infile, input);
+      return(EXIT_SUCCESS);
     }
 
-    // Lets perform the operation
-    useAPI(x, input, outputSize);
+    if ( input.Matrix() ) { // 2D input has its own reader and API
+      useMatrixAPI<T>(infile, input);
+      return(EXIT_SUCCESS);
+    }
+
+    if ( input.InputFormat() == "table" ) { // many series of one length, side by side
+      useTableAPI<T>(infile, input);
+      return(EXIT_SUCCESS);
+    }
+
+    if ( input.InputFormat() != "column" ) { // bedGraph or WIG ; many sequences
+      useTracksAPI<T>(infile, input);
+      return(EXIT_SUCCESS);
+    }
+
+    if ( input.Manifest() ) { // many independent series, each with its own outputs
+      useManifestAPI<T>(infile, input, argc, argv);
+      return(EXIT_SUCCESS);
+    }
+
+    Ext::MappedArray<T> x; // our original series
+    if ( !transform(infile, input, x) ) {
+      std::fprintf(stderr, "Unable to read numeric input");
+      return(EXIT_FAILURE);
+    }
 
     isError = false;
   } catch(Help& h) {
@@ -158,15 +386,28 @@ int main(int argc, char** argv)
 
 namespace {
 
+  //==============
+  // printSaved() : hands one level's retained values to a writer
+  //==============
+  template <typename T>
+  void printSaved(const std::vector<T>& values, int level, WT::PrintValues& op) {
+    op.Level(level);
+    for ( std::size_t i = 0; i < values.size(); ++i )
+      op(values[i]);
+  }
+
   //==========
   // useAPI()
   //==========
-  template <typename X>
-  void useAPI(std::vector<X>& x, const Input& input, std::size_t outputSize) {
-    // Create the requested wavelet filter and scaling filter
+  template <typename Sequence>
+  void useAPI(Sequence& x, const Input& input, std::size_t outputSize, const FilterPair* filters) {
+    typedef typename Sequence::value_type X;
+
+    // Create the requested wavelet filter and scaling filter, unless a caller keeps them
     WT::Filter::FType filterType = WT::Filter::selectFilter(input.FilterType());
-    WT::Filter::WaveletFilter wavefilt = WT::Filter::getFilters<WT::MODWT>(filterType).first;
-    WT::Filter::ScalingFilter scalefilt = WT::Filter::getFilters<WT::MODWT>(filterType).second;
+    const FilterPair built = filters ? FilterPair() : WT::Filter::getFilters<WT::MODWT>(filterType);
+    const WT::Filter::WaveletFilter& wavefilt = (filters ? *filters : built).first;
+    const WT::Filter::ScalingFilter& scalefilt = (filters ? *filters : built).second;
 
     // Locals
     Operation op = input.Op();
@@ -174,10 +415,17 @@ namespace {
     std::string prefix = input.Prefix();
     bool useStdout = input.StdOut();
 
+    // --levels outside of bandpass : only these levels are computed and written
+    const std::vector<int>& levels = input.Levels();
+    bool select = (op != BANDPASS && !levels.empty());
+
 
     // All needed operations are defined here -> switch doesn't allow local
     //  variables within a case.
 
+    // Declared ahead of every op that may write to it -> it outlives them
+    std::unique_ptr<WT::PyramidIndex> pyramid(input.Pyramid().empty() ? 0 : new WT::PyramidIndex(input.Pyramid()));
+
     // Scaling coefficient related operations
     std::string scaleName = prefix + "scaling-coefficients";
     WT::DoNothing vop0;
@@ -195,56 +443,1076 @@ namespace {
     std::string smoothName = prefix + "smoothing";
     // (currently unused) WT::DoNothing sop0;
     WT::PrintValues sop1((useStdout ? "" : smoothName), outputSize, maxLevel);
+    WT::PrintValues sop2(smoothName, outputSize); // every level for smooths()
+
+    // DWT coefficient sets shrink by half with each level -> print them all
+    WT::PrintValues vop3(scaleName, std::numeric_limits<std::size_t>::max(), maxLevel);
+    WT::PrintValues wop4(waveletName);
 
     // Operations related to the details
     std::string detailsName = prefix + "details";
     // (currently unused) WT::DoNothing dop0;
     WT::PrintLast dop1(detailsName, outputSize, 0); // special op for doAll() & mra()
+    WT::PrintValues dop2(detailsName, outputSize); // one file per Level() for dwt_mra()
     std::vector< WT::PrintValues > dops; // container of ops for details()
     for ( int i = 0; i < maxLevel; ++i )
       dops.push_back(WT::PrintValues(detailsName, outputSize, i+1));
+    std::vector< WT::PrintValues > sdops; // container of ops for details_levels()
+    for ( std::size_t i = 0; select && i < levels.size(); ++i )
+      sdops.push_back(WT::PrintValues(detailsName, outputSize, levels[i]));
+
+    // Local energy over a sliding --window instead of values
+    std::size_t window = input.Window(), step = input.WindowStep();
+    WT::PrintWindowed wop5(prefix + "wavelet-energy", std::max<std::size_t>(window, 1), step, outputSize);
+    std::vector< WT::PrintWindowed > edops; // container of ops for details()
+    for ( int i = 0; window > 0 && i < maxLevel; ++i )
+      edops.push_back(WT::PrintWindowed(prefix + "details-energy", window, step, outputSize, i+1));
+
+    // Wavelet packet coefficients -> one file per node
+    std::string packetName = prefix + "packet-coefficients";
+    WT::PrintNodes pop1(packetName, outputSize);
+
+    // Denoised series -> printed at the last step of the inverse
+    std::string denoiseName = prefix + "denoised";
+    WT::PrintValues nop1((useStdout ? "" : denoiseName), outputSize, maxLevel);
+
+    // Band-passed series -> printed at the last step of its inverse, like the denoised
+    std::string bandpassName = prefix + "bandpass";
+    WT::PrintValues bop1((useStdout ? "" : bandpassName), outputSize, maxLevel);
+
+    // Extrema of the details and smooth -> a small table rather than waveforms
+    double high = (op == PEAKS) ? input.PeakHigh() : 1, low = (op == PEAKS) ? input.PeakLow() : 1;
+    WT::DetectPeaks kop1(high, low, 0, true, outputSize); // details ; like PrintLast
+    WT::DetectPeaks kop2(high, low, maxLevel, true, outputSize); // smooth
+
+    // Largest wavelet coefficients only -> a sparse table ; the --level scaling coefficients are kept whole
+    WT::SparseCoefficients<X> zvop(0, -1, false, outputSize, maxLevel);
+    WT::SparseCoefficients<X> zwop(input.TopK(), input.MinMagnitude(), input.TopKGlobal(), outputSize);
 
+    // Wavelet variance -> a small table rather than coefficients
+    WT::WaveletVariance wvop(wavefilt.size(), outputSize);
 
+    // Every coefficient in one binary file for --operation inverse ; opened only when asked for
+    std::unique_ptr< WT::PrintContainer<X> > cop(op != CONTAINER ? 0 :
+                                                 new WT::PrintContainer<X>(prefix + "coefficients.modwt", outputSize,
+                                                                           maxLevel, input.FilterType()));
 
-    // I didn't implement anything for the library's imodwt() here
+    // Every waveform writer ; --output-bin and --pyramid apply to all of them
+    std::vector<WT::PrintValues*> writers = { &vop1, &wop1, &sop1, &sop2, &vop3, &wop4, &dop1, &dop2, &pop1, &nop1, &bop1 };
+    for ( std::size_t i = 0; i < dops.size(); ++i )
+      writers.push_back(&dops[i]);
+    for ( std::size_t i = 0; i < sdops.size(); ++i )
+      writers.push_back(&sdops[i]);
+
+    // --output-bin : coarser waveforms, one value per bin
+    if ( input.OutputBin() > 0 || input.OutputBinAuto() ) {
+      std::size_t bin = input.OutputBinAuto() ? 1 : input.OutputBin();
+      for ( std::size_t i = 0; i < writers.size(); ++i )
+        writers[i]->Bin(bin, input.OutputBinStat(), input.OutputBinAuto());
+    }
+
+    // --pyramid : tile summaries of every waveform written, in the same pass
+    for ( std::size_t i = 0; pyramid && i < writers.size(); ++i )
+      writers[i]->Index(pyramid.get());
+
+
+
+    // --region : only the part of the cascade that positions [first, last) depend on
+    std::size_t first = input.RegionFirst(), last = input.RegionLast();
+    bool region = last > 0;
+    Ext::Assert<Ext::UserError>(last <= outputSize, "--region extends past the end of the input");
+
+
+
+    // --operation inverse goes through useInverseAPI() instead
     // The library API and its usage below are meant to maximize runtime performance
+    //  modwt() given the filterType uses a prefix-sum engine for Haar
     switch (op) {
       case WAVE_COEFFS:
-        WT::modwt(x, wavefilt, scalefilt, maxLevel, vop0, wop1);
+        if ( region )
+          WT::modwt_region(x, wavefilt, scalefilt, maxLevel, first, last, vop0, wop1);
+        else if ( select ) // no scaling coefficients needed past the deepest chosen level
+          WT::modwt_levels(x, filterType, levels.back(), levels, vop0, wop1);
+        else if ( window > 0 )
+          WT::modwt(x, filterType, maxLevel, vop0, wop5);
+        else
+          WT::modwt(x, filterType, maxLevel, vop0, wop1);
         break;
       case SCALE_COEFFS:
-        WT::modwt(x, wavefilt, scalefilt, maxLevel, vop1, wop0);
+        if ( region )
+          WT::modwt_region(x, wavefilt, scalefilt, maxLevel, first, last, vop1, wop0);
+        else
+          WT::modwt(x, filterType, maxLevel, vop1, wop0);
         break;
       case WAVE_SCALE_COEFFS:
-        WT::modwt(x, wavefilt, scalefilt, maxLevel, vop1, wop1);
+        if ( region )
+          WT::modwt_region(x, wavefilt, scalefilt, maxLevel, first, last, vop1, wop1);
+        else if ( select )
+          WT::modwt_levels(x, filterType, maxLevel, levels, vop1, wop1);
+        else
+          WT::modwt(x, filterType, maxLevel, vop1, wop1);
         break;
       case SMOOTH:
-        WT::modwt(x, wavefilt, scalefilt, maxLevel, vop2, wop0);
+        if ( region ) {
+          WT::smooth_region(x, scalefilt, maxLevel, first, last, sop1);
+          break;
+        }
+        WT::modwt(x, filterType, maxLevel, vop2, wop0);
         WT::smooth(vop2.Values(), scalefilt, maxLevel, sop1);
         break;
       case DETAILS:
-        WT::modwt(x, wavefilt, scalefilt, maxLevel, vop0, wop3);
-        WT::details(wop3.Values(), wavefilt, scalefilt, dops);
+        if ( region ) {
+          for ( int i = 0; i < maxLevel; ++i )
+            WT::detail_region(x, wavefilt, scalefilt, i+1, first, last, dops[i]);
+          break;
+        }
+        else if ( select ) {
+          WT::modwt_levels(x, filterType, levels.back(), levels, vop0, wop3);
+          WT::details_levels(wop3.Values(), levels, wavefilt, scalefilt, sdops);
+          break;
+        }
+        WT::modwt(x, filterType, maxLevel, vop0, wop3);
+        if ( window > 0 )
+          WT::details(wop3.Values(), wavefilt, scalefilt, edops);
+        else
+          WT::details(wop3.Values(), wavefilt, scalefilt, dops);
         break;
       case MRA:
-        WT::mra(x, maxLevel, filterType, dop1, sop1);
+        if ( region ) {
+          for ( int i = 0; i < maxLevel; ++i )
+            WT::detail_region(x, wavefilt, scalefilt, i+1, first, last, dops[i]);
+          WT::smooth_region(x, scalefilt, maxLevel, first, last, sop1);
+        }
+        else if ( select ) {
+          WT::modwt_levels(x, filterType, maxLevel, levels, vop2, wop3);
+          WT::details_levels(wop3.Values(), levels, wavefilt, scalefilt, sdops);
+          WT::smooth(vop2.Values(), scalefilt, maxLevel, sop1);
+        }
+        else
+          WT::mra(x, maxLevel, filterType, dop1, sop1);
+        break;
+      case DWT_COEFFS:
+        WT::dwt(x, WT::Filter::getFilters<WT::DWT>(filterType).first,
+                WT::Filter::getFilters<WT::DWT>(filterType).second, maxLevel, vop3, wop4);
+        break;
+      case DWT_MRA:
+        WT::dwt_mra(x, maxLevel, filterType, dop2, sop1);
+        break;
+      case PACKETS: // --nodes, if given, replaces the full tree at --level
+        if ( input.Nodes().Empty() )
+          WT::modwpt(x, wavefilt, scalefilt, WT::TerminalNodes(maxLevel), pop1);
+        else
+          WT::modwpt(x, wavefilt, scalefilt, input.Nodes(), pop1);
+        break;
+      case VARIANCE:
+        WT::modwt(x, filterType, maxLevel, vop0, wvop);
+        printVariance(wvop.Estimates(), useStdout ? "" : prefix + "wavelet-variance");
+        break;
+      case PEAKS:
+        WT::mra(x, maxLevel, filterType, kop1, kop2);
+        printPeaks(kop1, kop2, useStdout ? "" : prefix + "peaks");
+        break;
+      case XCORR:
+        crossCorrelate(x, input, outputSize, wavefilt, scalefilt);
+        break;
+      case DENOISE:
+        WT::denoise(x, filterType, maxLevel, input.ThresholdRule(), input.Shrink(), nop1);
+        break;
+      case BANDPASS:
+        WT::bandpass(x, filterType, maxLevel, input.Levels(), input.LevelsSmooth(), bop1);
+        break;
+      case SMOOTHS:
+        WT::smooths(x, maxLevel, filterType, sop2);
+        break;
+      case SPARSE:
+        WT::modwt(x, filterType, maxLevel, zvop, zwop);
+        printSparse(zvop.Entries(), zwop.Entries(), outputSize, input.FilterType(), useStdout ? "" : prefix + "sparse-coefficients");
+        break;
+      case CONTAINER:
+        WT::modwt(x, filterType, maxLevel, cop->Scaling(), cop->Wavelet());
+        cop->Close();
         break;
       default: // ALL
-        WT::doAll(x, maxLevel, filterType, wop1, dop1, vop1, sop1);
+        if ( select ) { // the chosen coefficients are kept for their details, then written
+          WT::modwt_levels(x, filterType, maxLevel, levels, vop2, wop3);
+          for ( std::size_t i = 0; i < levels.size(); ++i )
+            printSaved(wop3.Values()[i], levels[i], wop1);
+          printSaved(vop2.Values(), maxLevel, vop1);
+          WT::details_levels(wop3.Values(), levels, wavefilt, scalefilt, sdops);
+          WT::smooth(vop2.Values(), scalefilt, maxLevel, sop1);
+        }
+        else
+          WT::doAll(x, maxLevel, filterType, wop1, dop1, vop1, sop1);
+    };
+
+    // --pyramid : end every track, then write the directory ; failures are reported
+    //  here rather than swallowed by destructors
+    if ( pyramid ) {
+      for ( std::size_t i = 0; i < writers.size(); ++i )
+        writers[i]->Close();
+      pyramid->Close();
+    }
+  }
+
+  //=================
+  // runsOperation() : the --operation on a RunSeries ; shared by --runs and track input
+  //=================
+  template <typename T, typename Filter1, typename Filter2, typename VOp, typename WOp, typename SOp, typename DOp>
+  void runsOperation(Operation op, const WT::RunSeries<T>& runs, const Filter1& wavefilt, const Filter2& scalefilt,
+                     int maxLevel, VOp& vop, WOp& wop, SOp& sop, DOp& dop) {
+    WT::DoNothing none;
+    switch (op) {
+      case WAVE_COEFFS:
+        WT::modwt_runs(runs, wavefilt, scalefilt, maxLevel, none, wop);
+        break;
+      case SCALE_COEFFS:
+        WT::modwt_runs(runs, wavefilt, scalefilt, maxLevel, vop, none);
+        break;
+      case WAVE_SCALE_COEFFS:
+        WT::modwt_runs(runs, wavefilt, scalefilt, maxLevel, vop, wop);
+        break;
+      case SMOOTH:
+        WT::smooth_runs(runs, scalefilt, maxLevel, sop);
+        break;
+      case DETAILS:
+        WT::details_runs(runs, wavefilt, scalefilt, maxLevel, dop);
+        break;
+      case MRA:
+        WT::mra_runs(runs, wavefilt, scalefilt, maxLevel, dop, sop);
+        break;
+      default: // ALL
+        WT::modwt_runs(runs, wavefilt, scalefilt, maxLevel, vop, wop);
+        WT::mra_runs(runs, wavefilt, scalefilt, maxLevel, dop, sop);
     };
   }
 
+  //==============
+  // useRunsAPI() : --runs ; the run-length engine, with runs as output
+  //==============
+  template <typename Sequence>
+  void useRunsAPI(Sequence& x, const Input& input, std::size_t outputSize, const FilterPair* filters) {
+    typedef typename Sequence::value_type X;
+
+    WT::Filter::FType filterType = WT::Filter::selectFilter(input.FilterType());
+    const FilterPair built = filters ? FilterPair() : WT::Filter::getFilters<WT::MODWT>(filterType);
+    const WT::Filter::WaveletFilter& wavefilt = (filters ? *filters : built).first;
+    const WT::Filter::ScalingFilter& scalefilt = (filters ? *filters : built).second;
+
+    int maxLevel = input.MaxLevel();
+    std::string prefix = input.Prefix();
+    bool useStdout = input.StdOut();
+
+    // Work follows the number of runs from here on
+    WT::RunSeries<X> runs = WT::encode_runs(x);
+
+    WT::PrintRuns vop((useStdout ? "" : prefix + "scaling-coefficients"), outputSize, maxLevel);
+    WT::PrintRuns wop(prefix + "wavelet-coefficients", outputSize);
+    WT::PrintRuns sop((useStdout ? "" : prefix + "smoothing"), outputSize, maxLevel);
+    WT::PrintRuns dop(prefix + "details", outputSize);
+    runsOperation(input.Op(), runs, wavefilt, scalefilt, maxLevel, vop, wop, sop, dop);
+  }
+
+  //=================
+  // useFiltersAPI() : several --filter's over one input, which is read only once
+  //=================
+  // o coefficients and variances share one pass over the input ; see useSweepAPI()
+  // o anything else runs once per filter on its own copy of x
+  // o each filter's output names start with its own tag: <prefix><filter>.
+  //=================
+  template <typename Sequence>
+  void useFiltersAPI(Sequence& x, const Input& input, std::size_t outputSize) {
+    Operation op = input.Op();
+    bool shared = (op == WAVE_COEFFS || op == SCALE_COEFFS || op == WAVE_SCALE_COEFFS || op == VARIANCE);
+    if ( shared && !input.Runs() && input.Window() == 0 && input.RegionLast() == 0 && input.Levels().empty() ) {
+      useSweepAPI(x, input, outputSize);
+      return;
+    }
+
+    const std::vector<std::string>& filters = input.Filters();
+    for ( std::size_t f = 0; f < filters.size(); ++f ) {
+      Sequence cpy(x); // most operations write over their input
+      if ( input.Runs() )
+        useRunsAPI(cpy, input.ForFilter(filters[f]), outputSize);
+      else
+        useAPI(cpy, input.ForFilter(filters[f]), outputSize);
+    } // for
+  }
+
+  //===============
+  // useSweepAPI() : wave, scale, wave-scale or variance for several --filter's ; WT::modwt_sweep()
+  //===============
+  template <typename Sequence>
+  void useSweepAPI(const Sequence& x, const Input& input, std::size_t outputSize) {
+    const std::vector<std::string>& filters = input.Filters();
+    std::vector<WT::Filter::FType> types;
+    for ( std::size_t f = 0; f < filters.size(); ++f )
+      types.push_back(WT::Filter::selectFilter(filters[f]));
+
+    int maxLevel = input.MaxLevel();
+    std::string prefix = input.Prefix();
+    std::vector<WT::DoNothing> none(filters.size());
+
+    // Per-filter wavelet variance -> one table with a column naming the filter
+    if ( input.Op() == VARIANCE ) {
+      std::vector<WT::WaveletVariance> wvops;
+      for ( std::size_t f = 0; f < types.size(); ++f )
+        wvops.push_back(WT::WaveletVariance(WT::Filter::getFilters<WT::MODWT>(types[f]).first.size(), outputSize));
+      WT::modwt_sweep(x, types, maxLevel, none, wvops);
+      printVariances(filters, wvops, input.StdOut() ? "" : prefix + "wavelet-variance");
+      return;
+    }
+
+    std::vector<WT::PrintValues> vops, wops;
+    for ( std::size_t f = 0; f < filters.size(); ++f ) {
+      std::string tag = prefix + filters[f] + ".";
+      vops.push_back(WT::PrintValues(tag + "scaling-coefficients", outputSize, maxLevel));
+      wops.push_back(WT::PrintValues(tag + "wavelet-coefficients", outputSize));
+      if ( input.OutputBin() > 0 || input.OutputBinAuto() ) {
+        std::size_t bin = input.OutputBinAuto() ? 1 : input.OutputBin();
+        vops.back().Bin(bin, input.OutputBinStat(), input.OutputBinAuto());
+        wops.back().Bin(bin, input.OutputBinStat(), input.OutputBinAuto());
+      }
+    } // for
+
+    switch (input.Op()) {
+      case WAVE_COEFFS:
+        WT::modwt_sweep(x, types, maxLevel, none, wops);
+        break;
+      case SCALE_COEFFS:
+        WT::modwt_sweep(x, types, maxLevel, vops, none);
+        break;
+      default: // WAVE_SCALE_COEFFS
+        WT::modwt_sweep(x, types, maxLevel, vops, wops);
+    };
+  }
+
+  //=================
+  // TrackTransform : one Track's --operation, as a job for Ext::parallelFor()
+  //=================
+  // o a Track's runs are written, then freed, as soon as it and every Track
+  //   before it in the input are done ; files keep input order
+  // o a Track more than --threads ahead of the first unwritten one waits to
+  //   start, so output that cannot keep up bounds how much is held
+  // o one bedGraph file per kind and level, opened when first written to
+  //=================
+  template <typename T>
+  struct TrackTransform {
+    struct Result {
+      Result(std::size_t n, int maxLevel) : vop_(n, maxLevel), wop_(n), sop_(n, maxLevel), dop_(n)
+        { /* */ }
+      WT::SaveRuns<T> vop_, wop_, sop_, dop_;
+    };
+
+    TrackTransform(const std::vector< WT::Track<T> >& tracks, const Input& input)
+        : tracks_(tracks), op_(input.Op()), maxLevel_(input.MaxLevel()),
+          reflect_(WT::selectBoundary(input.BoundaryType()) == WT::Reflected),
+          ahead_(std::max<std::size_t>(input.Threads(), 1)), done_(tracks.size(), false),
+          next_(0), writing_(false) {
+      WT::Filter::FType filterType = WT::Filter::selectFilter(input.FilterType());
+      wavefilt_ = WT::Filter::getFilters<WT::MODWT>(filterType).first;
+      scalefilt_ = WT::Filter::getFilters<WT::MODWT>(filterType).second;
+      for ( std::size_t i = 0; i < tracks_.size(); ++i ) {
+        const std::size_t n = tracks_[i].values_.size() * (reflect_ ? 2 : 1);
+        results_.push_back(Result(n, maxLevel_));
+      } // for
+
+      std::string prefix = input.Prefix();
+      bool useStdout = input.StdOut();
+      names_[0] = useStdout ? "" : prefix + "scaling-coefficients";
+      names_[1] = prefix + "wavelet-coefficients";
+      names_[2] = prefix + "details";
+      names_[3] = useStdout ? "" : prefix + "smoothing";
+    }
+
+    void operator()(std::size_t i) {
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while ( i >= next_ + ahead_ )
+          written_.wait(lock);
+      }
+
+      Result& r = results_[i];
+      const WT::Track<T>& track = tracks_[i];
+      if ( reflect_ )
+        runsOperation(op_, WT::reflect_runs(track.values_), wavefilt_, scalefilt_, maxLevel_, r.vop_, r.wop_, r.sop_, r.dop_);
+      else
+        runsOperation(op_, track.values_, wavefilt_, scalefilt_, maxLevel_, r.vop_, r.wop_, r.sop_, r.dop_);
+
+      // one thread at a time writes every finished Track at the front ; the
+      //  rest go back to work
+      std::unique_lock<std::mutex> lock(mtx_);
+      done_[i] = true;
+      if ( writing_ )
+        return;
+      writing_ = true;
+      while ( next_ < tracks_.size() && done_[next_] ) {
+        const std::size_t k = next_;
+        lock.unlock();
+        print(k);
+        results_[k] = Result(0, maxLevel_);
+        lock.lock();
+        ++next_;
+        written_.notify_all();
+      } // while
+      writing_ = false;
+    }
+
+    void Close() {
+      for ( std::map<std::string, FILE*>::iterator f = files_.begin(); f != files_.end(); ++f ) {
+        if ( f->second != stdout )
+          std::fclose(f->second);
+      } // for
+      files_.clear();
+    }
+
+    ~TrackTransform()
+      { Close(); }
+
+  private:
+    FILE* file(const std::string& name, int level) {
+      if ( name.empty() )
+        return(stdout);
+      std::stringstream s;
+      s << name << "." << level;
+      FILE*& out = files_[s.str()];
+      if ( !out ) {
+        out = std::fopen(s.str().c_str(), "w");
+        Ext::Assert<Ext::InvalidFile>(out != 0, "Unable to open file for writing: " + s.str());
+      }
+      return(out);
+    }
+
+    void print(std::size_t k) {
+      typedef typename std::map< int, WT::RunSeries<T> >::const_iterator LevelIter;
+      const WT::SaveRuns<T>* which[4] = { &results_[k].vop_, &results_[k].wop_, &results_[k].dop_, &results_[k].sop_ };
+      for ( std::size_t w = 0; w < 4; ++w ) {
+        const std::map< int, WT::RunSeries<T> >& levels = which[w]->Levels();
+        for ( LevelIter l = levels.begin(); l != levels.end(); ++l )
+          WT::writeBedGraph(file(names_[w], l->first), tracks_[k], l->second, tracks_[k].values_.size());
+      } // for
+    }
+
+  private:
+    const std::vector< WT::Track<T> >& tracks_;
+    Operation op_;
+    int maxLevel_;
+    bool reflect_;
+    std::size_t ahead_;
+    WT::Filter::WaveletFilter wavefilt_;
+    WT::Filter::ScalingFilter scalefilt_;
+    std::vector<Result> results_;
+    std::string names_[4];
+    std::map<std::string, FILE*> files_;
+    std::vector<bool> done_;
+    std::size_t next_;
+    bool writing_;
+    std::mutex mtx_;
+    std::condition_variable written_;
+  };
+
+  //================
+  // useTracksAPI() : --input-format bedgraph|wig ; chromosomes transformed in parallel
+  //================
+  template <typename T>
+  void useTracksAPI(FILE* infile, const Input& input) {
+    std::vector< WT::Track<T> > tracks;
+    if ( input.InputFormat() == "wig" )
+      WT::readWig(infile, tracks);
+    else
+      WT::readBedGraph(infile, tracks);
+
+    // input order: output is written in that order as chromosomes finish, so
+    //  only about --threads of them are ever held at once
+    std::vector<std::size_t> order;
+    for ( std::size_t i = 0; i < tracks.size(); ++i )
+      order.push_back(i);
+
+    TrackTransform<T> job(tracks, input);
+    Ext::parallelFor(order, input.Threads(), job);
+    job.Close();
+  }
+
+  //=============
+  // transform() : read one column of values into x and perform the --operation
+  //=============
+  // o false when the input is not numeric
+  // o 'filters', when given, are those of --filter and are not built again
+  //=============
+  template <typename T>
+  bool transform(FILE* infile, const Input& input, Ext::MappedArray<T>& x, const FilterPair* filters) {
+    if ( !readSeries(infile, x) )
+      return(false);
+
+    // Deal with possible reflected boundary
+    std::size_t outputSize = x.size();
+    WT::Boundary boundaryType = WT::selectBoundary(input.BoundaryType());
+    if ( boundaryType == WT::Reflected )
+      reflect(x);
+
+    // Lets perform the operation
+    if ( input.Filters().size() > 1 )
+      useFiltersAPI(x, input, outputSize);
+    else if ( input.Runs() )
+      useRunsAPI(x, input, outputSize, filters);
+    else
+      useAPI(x, input, outputSize, filters);
+    return(true);
+  }
+
+  //===============
+  // ManifestRun : one --manifest line's transform, as a job for WT::batch()
+  //===============
+  template <typename T>
+  struct ManifestRun {
+    explicit ManifestRun(const std::vector<Input>& jobs) : jobs_(jobs)
+      { /* */ }
+
+    void operator()(std::size_t i, WT::Workspace< Ext::MappedArray<T> >& space) {
+      Ext::FPWrap<Ext::InvalidFile> infile(jobs_[i].File());
+      Ext::MappedArray<T>& x = space.Series();
+      x.clear(); // keeps its pages for the next series
+      const FilterPair& filters = space.Filters(WT::Filter::selectFilter(jobs_[i].FilterType())); // built once per worker
+      if ( !transform(infile, jobs_[i], x, &filters) )
+        throw(Ext::InvalidFile("Unable to read numeric input: " + std::string(jobs_[i].File())));
+    }
+
+    const std::vector<Input>& jobs_;
+  };
+
+  //==================
+  // useManifestAPI() : --manifest ; one transform per manifest line, in parallel
+  //==================
+  // o each line is <file-name> TAB <prefix> [TAB <option value ...>] ; blank
+  //    lines and lines starting with '#' are skipped
+  // o a line's options follow, and so override, those of the command line
+  //==================
+  template <typename T>
+  void useManifestAPI(FILE* manifest, const Input& input, int argc, char** argv) {
+    std::vector<std::string> common;
+    for ( int i = 0; i < argc - 1; ++i ) {
+      if ( std::string(argv[i]) != "--manifest" )
+        common.push_back(argv[i]);
+    } // for
+
+    std::vector<Input> jobs;
+    std::vector<std::size_t> sizes;
+    char buf[8192];
+    for ( std::size_t line = 1; std::fgets(buf, sizeof(buf), manifest); ++line ) {
+      std::string row(buf);
+      while ( !row.empty() && (row[row.size()-1] == '\n' || row[row.size()-1] == '\r') )
+        row.erase(row.size()-1);
+      if ( row.empty() || row[0] == '#' )
+        continue;
+
+      std::vector<std::string> fields;
+      std::stringstream ss(row);
+      for ( std::string f; std::getline(ss, f, '\t'); )
+        fields.push_back(f);
+      std::stringstream where;
+      where << "--manifest line " << line;
+      Ext::Assert<Ext::UserError>(fields.size() >= 2 && fields.size() <= 3 && !fields[0].empty() && !fields[1].empty(),
+                                  where.str() + ": expect <file-name> <prefix> [<options>], tab separated");
+      Ext::Assert<Ext::UserError>(fields[0] != "-", where.str() + ": jobs may not read stdin");
+
+      std::vector<std::string> args(common);
+      args.push_back("--prefix");
+      args.push_back(fields[1]);
+      std::stringstream options(fields.size() > 2 ? fields[2] : "");
+      for ( std::string o; options >> o; )
+        args.push_back(o);
+      args.push_back(fields[0]);
+      std::vector<char*> jargv;
+      for ( std::size_t i = 0; i < args.size(); ++i )
+        jargv.push_back(&args[i][0]);
+      jobs.push_back(Input(static_cast<int>(jargv.size()), &jargv[0]));
+
+      const Input& job = jobs.back();
+      bool problem = job.Matrix() || job.StdOut() || job.InputFormat() != "column";
+      Ext::Assert<Ext::UserError>(!problem, where.str() + ": --manifest jobs may not use --matrix, --to-stdout or --input-format");
+      // output settings are process-wide ; they belong on the command line
+      problem = job.Binary() != input.Binary() || job.IOBackend() != input.IOBackend() || job.QueueDepth() != input.QueueDepth();
+      Ext::Assert<Ext::UserError>(!problem, where.str() + ": --binary, --io-backend and --queue-depth apply to every job ; give them on the command line");
+      struct stat st;
+      sizes.push_back(::stat(job.File(), &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0);
+    } // for
+
+    ManifestRun<T> run(jobs);
+    WT::batch< WT::Workspace< Ext::MappedArray<T> > >(sizes, input.Threads(), run);
+  }
+
+  //==================
+  // inverseFilters() : the filters for --operation inverse
+  //==================
+  // o 'recorded' is the --filter a coefficient file records, or "" when it records none
+  // o a recorded filter is used unless --filter is given, and must then match it
+  //==================
+  FilterPair inverseFilters(const Input& input, const std::string& recorded, const std::string& file) {
+    WT::Filter::FType given = WT::Filter::selectFilter(input.FilterType());
+    if ( recorded.empty() )
+      return(WT::Filter::getFilters<WT::MODWT>(given));
+
+    WT::Filter::FType ft;
+    try {
+      ft = WT::Filter::selectFilter(recorded);
+    } catch(Ext::ArgumentError&) {
+      throw(Ext::InvalidFile("Unknown filter recorded in " + file, recorded));
+    }
+    Ext::Assert<Ext::UserError>(!input.FilterGiven() || ft == given,
+                                "--filter " + input.FilterType() + " differs from the filter recorded in " + file,
+                                recorded);
+    return(WT::Filter::getFilters<WT::MODWT>(ft));
+  }
+
+  //===============
+  // looksLikeText() : true when the first bytes of a file are all printable or white space
+  //===============
+  bool looksLikeText(const char* bytes, std::size_t size) {
+    const std::size_t n = std::min<std::size_t>(size, 256);
+    for ( std::size_t i = 0; i < n; ++i ) {
+      const unsigned char c = static_cast<unsigned char>(bytes[i]);
+      if ( !(c == '\t' || c == '\n' || c == '\r' || (c >= 0x20 && c < 0x7f)) )
+        return(false);
+    } // for
+    return(n > 0);
+  }
+
+  //=================
+  // useInverseAPI() : --operation inverse ; coefficient files back to the series
+  //=================
+  // o <file-name> is one of
+  //    - a coefficients.modwt file from --operation container: a WT::ContainerHeader,
+  //       then V_J and W_1..W_J
+  //    - a scaling-coefficients.J file written with --binary, with the
+  //       wavelet-coefficients.1..J files of the same run beside it
+  //    - a sparse-coefficients file
+  //   J comes from the file, not --level
+  // o binary coefficients are mapped rather than read.  Only V_J is copied, since
+  //    imodwt() works on it in place, and the W_j are read straight from the maps.
+  // o --binary files carry no header, so they are refused if they look like text
+  //    or V_J holds a non-finite value, rather than inverted into garbage
+  //=================
+  template <typename T>
+  void useInverseAPI(FILE* infile, const Input& input) {
+    const std::string name = input.StdOut() ? "" : input.Prefix() + "reconstructed";
+    const std::string file = input.File();
+
+    char line[256] = { 0 };
+    const bool read = (0 != std::fgets(line, sizeof(line), infile));
+    if ( read && 0 == std::strncmp(line, "#length\t", 8) ) { // (kind, level, index, value) lines ; see printSparse()
+      typedef typename WT::SparseCoefficients<T>::Entry Entry;
+      const std::size_t length = static_cast<std::size_t>(std::strtoul(line + 8, 0, 10));
+      std::vector<Entry> scaling, wavelet;
+      std::string recorded;
+      int numLevels = 0;
+      while ( std::fgets(line, sizeof(line), infile) ) {
+        if ( 0 == std::strncmp(line, "#filter\t", 8) ) {
+          recorded = line + 8;
+          recorded.erase(recorded.find_last_not_of(" \t\r\n") + 1);
+        }
+        if ( line[0] == '#' )
+          continue;
+        char kind[16];
+        int level = 0;
+        unsigned long index = 0;
+        double value = 0;
+        const bool ok = (4 == std::sscanf(line, "%15s %d %lu %lf", kind, &level, &index, &value)) &&
+                        (0 == std::strcmp(kind, "scaling") || 0 == std::strcmp(kind, "wavelet"));
+        Ext::Assert<Ext::InvalidFile>(ok, "Bad sparse-coefficients line", line);
+        const Entry e = { level, static_cast<std::size_t>(index), static_cast<T>(value) };
+        (kind[0] == 's' ? scaling : wavelet).push_back(e);
+        numLevels = std::max(numLevels, level);
+      } // while
+
+      const FilterPair filters = inverseFilters(input, recorded, file);
+      WT::PrintValues out(name, length, 0);
+      WT::imodwt_sparse(scaling, wavelet, length, numLevels, filters.first, filters.second, out);
+      return;
+    }
+
+    std::vector< std::unique_ptr< Ext::MappedFile<T> > > maps;
+    std::vector<const T*> W; // W_1..W_J, straight from the maps
+    const T* V = 0;
+    std::size_t N = 0;
+    FilterPair filters;
+    if ( read && WT::ContainerHeader::HasMagic(line, sizeof(line)) ) { // one file ; see WT::PrintContainer
+      maps.push_back(std::unique_ptr< Ext::MappedFile<T> >(new Ext::MappedFile<T>(file)));
+      const Ext::MappedFile<T>& C = *maps.back();
+      const std::size_t head = sizeof(WT::ContainerHeader) / sizeof(T);
+      Ext::Assert<Ext::InvalidFile>(C.size() > head, "Truncated coefficient container", file);
+      WT::ContainerHeader h;
+      std::memcpy(&h, C.data(), sizeof(h));
+      Ext::Assert<Ext::InvalidFile>(h.order_ == 0x01020304 && h.valueBytes_ == sizeof(T),
+                                    "Coefficient container of another byte order or value type", file);
+      const std::size_t J = h.levels_, body = C.size() - head;
+      N = static_cast<std::size_t>(h.length_);
+      Ext::Assert<Ext::InvalidFile>(J > 0 && N > 0 && N <= body && body % (J + 1) == 0 && body / (J + 1) == N,
+                                    "Coefficient container size does not match its header", file);
+      filters = inverseFilters(input, h.Filter(), file);
+      V = C.data() + head;
+      for ( std::size_t j = 1; j <= J; ++j )
+        W.push_back(V + j * N);
+    }
+    else {
+      const std::string tag = "scaling-coefficients.";
+      const std::string::size_type at = file.rfind(tag);
+      char* end = 0;
+      const long J = (at == std::string::npos) ? 0 : std::strtol(file.c_str() + at + tag.size(), &end, 10);
+      Ext::Assert<Ext::UserError>(J > 0 && *end == '\0',
+                                  "--operation inverse expects a coefficients.modwt file, a scaling-coefficients.J file written with --binary, or a sparse-coefficients file",
+                                  file);
+
+      for ( long j = 0; j <= J; ++j ) { // V_J, then W_1..W_J
+        std::stringstream wname;
+        if ( j == 0 )
+          wname << file;
+        else
+          wname << file.substr(0, at) << "wavelet-coefficients." << j;
+        maps.push_back(std::unique_ptr< Ext::MappedFile<T> >(new Ext::MappedFile<T>(wname.str())));
+        const Ext::MappedFile<T>& m = *maps.back();
+        Ext::Assert<Ext::InvalidFile>(!looksLikeText(reinterpret_cast<const char*>(m.data()), m.size() * sizeof(T)),
+                                      "Text, not --binary coefficients", wname.str());
+        Ext::Assert<Ext::InvalidFile>(j == 0 || m.size() == N, "Coefficient files differ in length", wname.str());
+        if ( j == 0 )
+          V = m.data(), N = m.size();
+        else
+          W.push_back(m.data());
+      } // for
+      filters = inverseFilters(input, "", file);
+    }
+
+    Ext::MappedArray<T> v;
+    v.append(V, N);
+    for ( std::size_t i = 0; i < N; ++i )
+      Ext::Assert<Ext::InvalidFile>(std::isfinite(static_cast<double>(v[i])), "Non-finite scaling coefficient in", file);
+    WT::PrintValues out(name, N, 0);
+    WT::imodwt(v, W, filters.first, filters.second, out);
+  }
+
+  //==============
+  // readSeries() : parsing happens on the reader's own thread
+  //==============
+  // o x grows by remapping pages, never by copying, so peak memory while
+  //    reading a large stream stays at about the size of the data itself
+  //==============
+  template <typename T>
+  bool readSeries(FILE* infile, Ext::MappedArray<T>& x) {
+    Ext::BlockReader<T> reader(infile);
+    std::vector<T>* blk = 0;
+    while ( reader.Next(blk) )
+      x.append(blk->data(), blk->size());
+    return(!reader.Failed());
+  }
+
+  //===========
+  // reflect() : append the series to itself in reverse ; reflected boundary
+  //===========
+  template <typename T>
+  void reflect(Ext::MappedArray<T>& x) {
+    const std::size_t sz = x.size();
+    x.resize(2 * sz);
+    for ( std::size_t i = 2 * sz - 1, j = 0; i >= sz; )
+      x[i--] = x[j++];
+  }
+
+  //==================
+  // crossCorrelate() : x against every --with series ; a table to a file or stdout
+  //==================
+  template <typename Sequence, typename Filter1, typename Filter2>
+  void crossCorrelate(Sequence& x, const Input& input, std::size_t outputSize,
+                      const Filter1& wavefilt, const Filter2& scalefilt) {
+    const std::vector<std::string>& others = input.With();
+    const bool reflected = (WT::selectBoundary(input.BoundaryType()) == WT::Reflected);
+    const std::string name = input.StdOut() ? "" : input.Prefix() + "wavelet-xcorr";
+    Ext::FPWrap<Ext::InvalidFile> file; // closes the output however this returns
+    if ( !name.empty() )
+      file.Open(name, "w");
+    FILE* out = name.empty() ? stdout : static_cast<FILE*>(file);
+    std::fprintf(out, "#track\tlevel\tlag\tcount\tcovariance\tcorrelation\n");
+
+    // a single pair is transformed in lockstep ; several share one transform of x
+    std::unique_ptr< WT::ReferenceSeries<Sequence, Filter1, Filter2> > ref;
+    if ( others.size() > 1 )
+      ref.reset(new WT::ReferenceSeries<Sequence, Filter1, Filter2>(x, wavefilt, scalefilt, input.MaxLevel()));
+    for ( std::size_t i = 0; i < others.size(); ++i ) {
+      Sequence y;
+      {
+        Ext::FPWrap<Ext::InvalidFile> yfile(others[i]);
+        Ext::Assert<Ext::DataError>(readSeries(yfile, y), "Unable to read numeric input", others[i]);
+      }
+      if ( reflected )
+        reflect(y);
+      Ext::Assert<Ext::DataError>(y.size() == x.size(), "Series differ in length", others[i]);
+
+      WT::WaveletCrossCorrelation xop(wavefilt.size(), input.MaxLag(), outputSize);
+      if ( ref )
+        ref->Pair(y, xop);
+      else
+        WT::modwt_pair(x, y, wavefilt, scalefilt, input.MaxLevel(), xop);
+
+      const std::vector<WT::WaveletCrossCorrelation::Estimate>& est = xop.Estimates();
+      const long long maxLag = static_cast<long long>(xop.MaxLag());
+      for ( std::size_t e = 0; e < est.size(); ++e ) {
+        for ( long long lag = -maxLag; lag <= maxLag; ++lag ) {
+          std::fprintf(out, "%s\t%d\t%lld\t%lu\t%g\t%g\n", others[i].c_str(), est[e].level_, lag,
+                       static_cast<unsigned long>(est[e].count_), est[e].covariance_[lag + maxLag],
+                       est[e].correlation_[lag + maxLag]);
+        } // for
+      } // for
+    } // for
+  }
+
+  //==============
+  // printPeaks() : one line per extremum ; to stdout if 'name' is empty
+  //==============
+  void printPeaks(WT::DetectPeaks& details, WT::DetectPeaks& smooth, const std::string& name) {
+    FILE* out = stdout;
+    if ( !name.empty() ) {
+      out = std::fopen(name.c_str(), "w");
+      Ext::Assert<Ext::InvalidFile>(out != NULL, "Unable to open file for writing: " + name);
+    }
+    std::fprintf(out, "#waveform\tlevel\tposition\tamplitude\tline\n");
+    for ( int which = 0; which < 2; ++which ) {
+      const std::vector<WT::DetectPeaks::Event>& ev = (which == 0) ? details.Events() : smooth.Events();
+      for ( std::size_t i = 0; i < ev.size(); ++i ) {
+        std::fprintf(out, "%s\t%d\t%lu\t%g\t%ld\n", (which == 0) ? "details" : "smoothing", ev[i].level_,
+                     static_cast<unsigned long>(ev[i].position_), ev[i].amplitude_, ev[i].line_);
+      } // for
+    } // for
+    if ( out != stdout )
+      std::fclose(out);
+  }
+
+  //===============
+  // printSparse() : one line per kept coefficient ; to stdout if 'name' is empty
+  //===============
+  // o 'length' is the series length, needed to invert with WT::imodwt_sparse()
+  // o 'filter' is the --filter of the transform ; the inverse needs the same one
+  // o values keep full float precision rather than the %f used for waveforms
+  //===============
+  template <typename Entries>
+  void printSparse(const Entries& scaling, const Entries& wavelet, std::size_t length,
+                   const std::string& filter, const std::string& name) {
+    FILE* out = stdout;
+    if ( !name.empty() ) {
+      out = std::fopen(name.c_str(), "w");
+      Ext::Assert<Ext::InvalidFile>(out != NULL, "Unable to open file for writing: " + name);
+    }
+    std::fprintf(out, "#length\t%lu\n", static_cast<unsigned long>(length));
+    std::fprintf(out, "#filter\t%s\n", filter.c_str());
+    std::fprintf(out, "#kind\tlevel\tindex\tvalue\n");
+    for ( int which = 0; which < 2; ++which ) {
+      const Entries& e = (which == 0) ? scaling : wavelet;
+      for ( std::size_t i = 0; i < e.size(); ++i ) {
+        std::fprintf(out, "%s\t%d\t%lu\t%.9g\n", (which == 0) ? "scaling" : "wavelet", e[i].level_,
+                     static_cast<unsigned long>(e[i].index_), static_cast<double>(e[i].value_));
+      } // for
+    } // for
+    if ( out != stdout )
+      std::fclose(out);
+  }
+
+  //=================
+  // printVariance() : one line per level ; to stdout if 'name' is empty
+  //=================
+  void printVariance(const std::vector<WT::WaveletVariance::Estimate>& est, const std::string& name) {
+    FILE* out = stdout;
+    if ( !name.empty() ) {
+      out = std::fopen(name.c_str(), "w");
+      Ext::Assert<Ext::InvalidFile>(out != NULL, "Unable to open file for writing: " + name);
+    }
+    std::fprintf(out, "#level\tcount\tvariance\tlower95\tupper95\tedof\n");
+    writeVariance(out, est, "");
+    if ( out != stdout )
+      std::fclose(out);
+  }
+
+  //==================
+  // printVariances() : printVariance() for several filters ; the first column names the filter
+  //==================
+  void printVariances(const std::vector<std::string>& filters, std::vector<WT::WaveletVariance>& wvops,
+                      const std::string& name) {
+    FILE* out = stdout;
+    if ( !name.empty() ) {
+      out = std::fopen(name.c_str(), "w");
+      Ext::Assert<Ext::InvalidFile>(out != NULL, "Unable to open file for writing: " + name);
+    }
+    std::fprintf(out, "#filter\tlevel\tcount\tvariance\tlower95\tupper95\tedof\n");
+    for ( std::size_t f = 0; f < filters.size(); ++f )
+      writeVariance(out, wvops[f].Estimates(), filters[f] + "\t");
+    if ( out != stdout )
+      std::fclose(out);
+  }
+
+  //=================
+  // writeVariance() : one line per level, each starting with 'lead'
+  //=================
+  void writeVariance(FILE* out, const std::vector<WT::WaveletVariance::Estimate>& est, const std::string& lead) {
+    for ( std::size_t i = 0; i < est.size(); ++i ) {
+      const WT::WaveletVariance::Estimate& e = est[i];
+      std::fprintf(out, "%s%d\t%lu\t%g\t%g\t%g\t%g\n", lead.c_str(), e.level_, static_cast<unsigned long>(e.count_),
+                   e.variance_, e.lower_, e.upper_, e.edof_);
+    } // for
+  }
+
+  //================
+  // useMatrixAPI() : 2D input ; one matrix row per line
+  //================
+  template <typename T>
+  void useMatrixAPI(FILE* infile, const Input& input) {
+    // Read rows into a RowStore, on disk when streaming row bands.  A reflected
+    //  boundary doubles both dimensions: each row is followed by its mirror
+    //  image, and the rows are followed by themselves in reverse.
+    const bool reflect = (WT::selectBoundary(input.BoundaryType()) == WT::Reflected);
+    std::vector<T> row;
+    char* line = 0;
+    std::size_t lineSz = 0;
+    WT::RowStore<T>* X = 0;
+    std::size_t cols = 0;
+    try {
+      while ( ::getline(&line, &lineSz, infile) > 0 ) {
+        Ext::Assert<Ext::DataError>(parseRow(line, row), "Unable to read numeric matrix input", line);
+        if ( row.empty() ) // blank line
+          continue;
+        if ( !X ) {
+          cols = row.size();
+          X = new WT::RowStore<T>((reflect ? 2 : 1) * cols, input.RowBand() > 0);
+        }
+        Ext::Assert<Ext::DataError>(row.size() == cols, "Every matrix row must have the same number of columns");
+        if ( reflect ) { // mirror into new space ; insert() may not take a range of its own vector
+          row.resize(2 * cols);
+          std::reverse_copy(row.begin(), row.begin() + cols, row.begin() + cols);
+        }
+        X->Append(&row[0]);
+      } // while
+      std::free(line), line = 0;
+      Ext::Assert<Ext::DataError>(X != 0, "Empty matrix input");
+
+      const std::size_t rows = X->Rows();
+      if ( reflect ) {
+        row.resize(X->Cols());
+        for ( std::size_t r = rows; r > 0; --r ) {
+          X->GetRows(static_cast<long long>(r - 1), 1, &row[0]);
+          X->Append(&row[0]);
+        } // for
+      }
+
+      // Output: one file per subband and level ; see WT::PrintBands
+      WT::Filter::FType filterType = WT::Filter::selectFilter(input.FilterType());
+      int maxLevel = input.MaxLevel();
+      std::string prefix = input.Prefix();
+      Operation op = input.Op();
+      if ( op == MRA ) {
+        WT::PrintBands mop(prefix + "details", prefix + "smoothing", maxLevel, rows, cols);
+        WT::mra2d(*X, filterType, maxLevel, mop);
+      }
+      else {
+        std::string waveletName = (op == SCALE_COEFFS) ? "" : prefix + "wavelet-coefficients";
+        std::string scaleName = (op == WAVE_COEFFS) ? "" : prefix + "scaling-coefficients";
+        WT::PrintBands cop(waveletName, scaleName, maxLevel, rows, cols);
+        WT::modwt2d(*X, filterType, maxLevel, cop, input.RowBand());
+      }
+    } catch(...) {
+      std::free(line);
+      delete X;
+      throw;
+    }
+    delete X;
+  }
+
+  //===============
+  // useTableAPI() : --input-format table ; one column per series, all transformed together
+  //===============
+  template <typename T>
+  void useTableAPI(FILE* infile, const Input& input) {
+    std::vector<T> row;
+    char* line = 0;
+    std::size_t lineSz = 0;
+    std::unique_ptr< WT::MultiSeries<T> > X;
+    try {
+      while ( ::getline(&line, &lineSz, infile) > 0 ) {
+        Ext::Assert<Ext::DataError>(parseRow(line, row), "Unable to read numeric table input", line);
+        if ( row.empty() ) // blank line
+          continue;
+        if ( !X )
+          X.reset(new WT::MultiSeries<T>(row.size()));
+        Ext::Assert<Ext::DataError>(row.size() == X->Series(), "Every table row must have the same number of columns");
+        X->Append(&row[0]);
+      } // while
+    } catch(...) {
+      std::free(line);
+      throw;
+    }
+    std::free(line);
+    Ext::Assert<Ext::DataError>(X.get() != 0, "Empty table input");
+
+    // Deal with possible reflected boundary ; rows follow themselves in reverse
+    const std::size_t outputSize = X->size(), K = X->Series();
+    if ( WT::selectBoundary(input.BoundaryType()) == WT::Reflected ) {
+      for ( std::size_t t = outputSize; t > 0; --t ) {
+        row.assign(X->Row(t - 1), X->Row(t - 1) + K);
+        X->Append(&row[0]);
+      } // for
+    }
+
+    // One file per level, laid out like the input: a row per position, a column per series
+    int maxLevel = input.MaxLevel();
+    std::string prefix = input.Prefix();
+    std::vector<WT::DoNothing> none(K);
+    WT::PrintColumns vops(prefix + "scaling-coefficients", K, outputSize, maxLevel);
+    WT::PrintColumns wops(prefix + "wavelet-coefficients", K, outputSize);
+
+    WT::Filter::FType filterType = WT::Filter::selectFilter(input.FilterType());
+    switch (input.Op()) {
+      case WAVE_COEFFS:
+        WT::modwt_multi(*X, filterType, maxLevel, none, wops);
+        break;
+      case SCALE_COEFFS:
+        WT::modwt_multi(*X, filterType, maxLevel, vops, none);
+        break;
+      default: // WAVE_SCALE_COEFFS
+        WT::modwt_multi(*X, filterType, maxLevel, vops, wops);
+    };
+  }
+
+  //============
+  // parseRow() : whitespace-separated numbers ; false if anything else is on the line
+  //============
+  template <typename T>
+  bool parseRow(const char* line, std::vector<T>& row) {
+    row.clear();
+    const char* p = line;
+    while ( true ) {
+      char* end = 0;
+      double d = std::strtod(p, &end);
+      if ( end == p )
+        break;
+      row.push_back(static_cast<T>(d));
+      p = end;
+    } // while
+    while ( *p && std::isspace(static_cast<unsigned char>(*p)) )
+      ++p;
+    return(*p == '\0');
+  }
+
   //===========================================
   // Boring user input related implementations
   //===========================================
   Input::Input(int argc, char** argv)
-         : file_("-"), fType_("LA8"), bType_("Periodic"),
-           op_(SMOOTH), maxLevel_(4), toStdout_(false), prefix_("") {
+         : file_("-"), fType_("LA8"), bType_("Periodic"), filterGiven_(false), filters_(1, "la8"),
+           op_(SMOOTH), maxLevel_(4), levelsSmooth_(false), toStdout_(false), prefix_(""),
+           binary_(false), ioBackend_(WT::WriterOptions::AUTO), queueDepth_(8),
+           matrix_(false), rowBand_(0), rule_(WT::Threshold::UNIVERSAL), shrink_(WT::Threshold::SOFT),
+           maxLag_(0), window_(0), windowStep_(1), peakHigh_(0), peakLow_(-1),
+           outputBin_(0), binAuto_(false), binStat_(WT::PrintValues::MEAN),
+           regionFirst_(0), regionLast_(0), pyramid_(""), runs_(false),
+           inputFormat_("column"), threads_(std::max(1u, std::thread::hardware_concurrency())),
+           manifest_(false), topK_(0), topKGlobal_(false), minMagnitude_(0) {
 
     Ext::Assert<Ext::UserError>(argc >= 2, "Expect <file-name>");
     if ( lc(argv[argc-1]) == "--help" )
       throw(Help());
 
+    bool binStat = false;
     for ( int i = 1; i < argc - 1; ) {
       std::string option = lc(argv[i++]);
       std::string value = argv[i++];
@@ -252,16 +1520,84 @@ namespace {
       if ( option == "--help" || value == "--help" )
         throw(Help());
 
-      if ( option == "--boundary" )
+      if ( option == "--binary" ) {
+        binary_ = true;
+        --i; // a flag
+      }
+      else if ( option == "--boundary" )
         bType_ = value;
       else if ( option == "--filter" )
-        fType_ = value;
+        setFilter(value);
+      else if ( option == "--input-format" ) {
+        inputFormat_ = lc(value);
+        Ext::Assert<Ext::UserError>(inputFormat_ == "column" || inputFormat_ == "bedgraph" ||
+                                    inputFormat_ == "wig" || inputFormat_ == "table",
+                                    "Unknown --input-format: " + value, "expect column, table, bedgraph or wig");
+      }
+      else if ( option == "--io-backend" )
+        setIOBackend(value);
       else if ( option == "--level" )
         setLevel(value);
+      else if ( option == "--levels" )
+        levelsSpec_ = value; // may depend on --level, which may come later
+      else if ( option == "--manifest" ) {
+        manifest_ = true;
+        --i; // a flag
+      }
+      else if ( option == "--matrix" ) {
+        matrix_ = true;
+        --i; // a flag
+      }
+      else if ( option == "--max-lag" )
+        maxLag_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--min-magnitude" )
+        minMagnitude_ = toPlusNum(value);
+      else if ( option == "--nodes" )
+        setNodes(value);
       else if ( option == "--operation" )
         setOperation(value);
+      else if ( option == "--output-bin" )
+        setOutputBin(value);
+      else if ( option == "--output-bin-stat" ) {
+        setOutputBinStat(value);
+        binStat = true;
+      }
+      else if ( option == "--peak-high" )
+        peakHigh_ = toPlusNum(value);
+      else if ( option == "--peak-low" )
+        peakLow_ = toPlusNum(value);
       else if ( option == "--prefix" )
         prefix_ = value;
+      else if ( option == "--pyramid" )
+        pyramid_ = value;
+      else if ( option == "--queue-depth" )
+        queueDepth_ = toPlusInt(value);
+      else if ( option == "--region" )
+        setRegion(value);
+      else if ( option == "--row-band" )
+        rowBand_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--runs" ) {
+        runs_ = true;
+        --i; // a flag
+      }
+      else if ( option == "--shrink" )
+        shrink_ = WT::Threshold::selectShrink(value);
+      else if ( option == "--threads" )
+        threads_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--threshold" )
+        rule_ = WT::Threshold::selectRule(value);
+      else if ( option == "--top-k" )
+        topK_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--top-k-global" ) {
+        topKGlobal_ = true;
+        --i; // a flag
+      }
+      else if ( option == "--window" )
+        window_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--window-step" )
+        windowStep_ = static_cast<std::size_t>(toPlusInt(value));
+      else if ( option == "--with" )
+        setWith(value);
       else if ( option == "--to-stdout" ) {
         toStdout_ = true;          
         --i; // a flag
@@ -273,12 +1609,73 @@ namespace {
     } // for
 
     file_ = argv[argc-1];
-    bool problem = toStdout_ && op_ != SMOOTH && op_ != SCALE_COEFFS;
+    if ( !levelsSpec_.empty() )
+      setLevels(levelsSpec_);
+    bool problem = toStdout_ && op_ != SMOOTH && op_ != SCALE_COEFFS && op_ != VARIANCE && op_ != DENOISE && op_ != XCORR &&
+                   op_ != PEAKS && op_ != BANDPASS && op_ != SPARSE && op_ != INVERSE;
     Ext::Assert<Ext::UserError>(!problem,
                                 "--to-stdout not allowed for given --operation",
                                 "see --help for details");
     Ext::Assert<Ext::UserError>(!toStdout_ || prefix_.empty(),
                                 "cannot --to-stdout and add --prefix value"); 
+    Ext::Assert<Ext::UserError>(nodes_.Empty() || op_ == PACKETS,
+                                "--nodes only applies to --operation packets");
+    Ext::Assert<Ext::UserError>((op_ == XCORR) == !with_.empty(), "--operation xcorr requires --with and vice versa");
+    Ext::Assert<Ext::UserError>(op_ != BANDPASS || !levelsSpec_.empty(), "--operation bandpass requires --levels");
+    problem = !levelsSpec_.empty() && op_ != BANDPASS && op_ != WAVE_COEFFS && op_ != WAVE_SCALE_COEFFS &&
+              op_ != DETAILS && op_ != MRA && op_ != ALL;
+    Ext::Assert<Ext::UserError>(!problem, "--levels applies to --operation all, bandpass, details, mra, wave or wave-scale");
+    Ext::Assert<Ext::UserError>(!levelsSmooth_ || op_ == BANDPASS, "smooth in --levels only applies to --operation bandpass");
+    Ext::Assert<Ext::UserError>((op_ == SPARSE) == (topK_ > 0 || minMagnitude_ > 0),
+                                "--operation sparse requires --top-k and/or --min-magnitude, and vice versa");
+    Ext::Assert<Ext::UserError>(!topKGlobal_ || topK_ > 0, "--top-k-global requires --top-k");
+    Ext::Assert<Ext::UserError>(maxLag_ == 0 || op_ == XCORR, "--max-lag only applies to --operation xcorr");
+    Ext::Assert<Ext::UserError>((op_ == PEAKS) == (peakHigh_ > 0), "--operation peaks requires --peak-high and vice versa");
+    Ext::Assert<Ext::UserError>(peakLow_ < 0 || (op_ == PEAKS && peakLow_ <= peakHigh_),
+                                "--peak-low applies to --operation peaks and may not exceed --peak-high");
+    problem = window_ > 0 && (matrix_ || (op_ != WAVE_COEFFS && op_ != DETAILS));
+    Ext::Assert<Ext::UserError>(!problem, "--window applies to --operation wave or details");
+    Ext::Assert<Ext::UserError>(windowStep_ == 1 || window_ > 0, "--window-step requires --window");
+    problem = matrix_ && op_ != WAVE_COEFFS && op_ != SCALE_COEFFS && op_ != WAVE_SCALE_COEFFS && op_ != MRA;
+    Ext::Assert<Ext::UserError>(!problem, "--matrix allows --operation wave, scale, wave-scale or mra");
+    Ext::Assert<Ext::UserError>(!matrix_ || !toStdout_, "cannot --to-stdout with --matrix");
+    problem = rowBand_ > 0 && (!matrix_ || op_ == MRA);
+    Ext::Assert<Ext::UserError>(!problem, "--row-band requires --matrix and a coefficient --operation");
+    const bool binning = outputBin_ > 0 || binAuto_;
+    problem = binning && (matrix_ || window_ > 0 || op_ == VARIANCE || op_ == XCORR || op_ == PEAKS || op_ == SPARSE ||
+                          op_ == CONTAINER);
+    Ext::Assert<Ext::UserError>(!problem, "--output-bin applies to waveform outputs, without --matrix or --window");
+    Ext::Assert<Ext::UserError>(!binStat || binning, "--output-bin-stat requires --output-bin");
+    problem = regionLast_ > 0 && (matrix_ || window_ > 0 || (op_ != WAVE_COEFFS && op_ != SCALE_COEFFS &&
+                                  op_ != WAVE_SCALE_COEFFS && op_ != SMOOTH && op_ != DETAILS && op_ != MRA));
+    Ext::Assert<Ext::UserError>(!problem, "--region allows --operation wave, scale, wave-scale, smooth, details or mra");
+    problem = !pyramid_.empty() && (toStdout_ || matrix_ || window_ > 0 || op_ == VARIANCE || op_ == XCORR || op_ == PEAKS ||
+                                    op_ == SPARSE || op_ == CONTAINER);
+    Ext::Assert<Ext::UserError>(!problem, "--pyramid applies to waveform outputs, without --to-stdout, --matrix or --window");
+    const bool tracks = (inputFormat_ == "bedgraph" || inputFormat_ == "wig");
+    problem = (runs_ || tracks) && (op_ != WAVE_COEFFS && op_ != SCALE_COEFFS && op_ != WAVE_SCALE_COEFFS &&
+                        op_ != SMOOTH && op_ != DETAILS && op_ != MRA && op_ != ALL);
+    Ext::Assert<Ext::UserError>(!problem, "--runs and --input-format bedgraph|wig allow --operation all, details, mra, scale, smooth, wave or wave-scale");
+    problem = (runs_ || tracks) && (binary_ || matrix_ || binning || regionLast_ > 0 || window_ > 0 || !pyramid_.empty());
+    Ext::Assert<Ext::UserError>(!problem, "--runs and --input-format bedgraph|wig may not be used with --binary, --matrix, --output-bin, --pyramid, --region or --window");
+    const bool table = (inputFormat_ == "table");
+    problem = table && (op_ != WAVE_COEFFS && op_ != SCALE_COEFFS && op_ != WAVE_SCALE_COEFFS);
+    Ext::Assert<Ext::UserError>(!problem, "--input-format table allows --operation wave, scale or wave-scale");
+    problem = table && (toStdout_ || matrix_ || runs_ || binning || regionLast_ > 0 || window_ > 0 || !pyramid_.empty());
+    Ext::Assert<Ext::UserError>(!problem, "--input-format table may not be used with --matrix, --output-bin, --pyramid, --region, --runs, --to-stdout or --window");
+    problem = manifest_ && (matrix_ || tracks || table || toStdout_ || !pyramid_.empty() || !prefix_.empty());
+    Ext::Assert<Ext::UserError>(!problem, "--manifest may not be used with --input-format, --matrix, --prefix, --pyramid or --to-stdout");
+    problem = !levelsSpec_.empty() && op_ != BANDPASS && (matrix_ || runs_ || tracks || table || regionLast_ > 0 || window_ > 0);
+    Ext::Assert<Ext::UserError>(!problem, "--levels may not be used with --input-format, --matrix, --region, --runs or --window");
+    problem = op_ == INVERSE && (manifest_ || filters_.size() > 1 || WT::selectBoundary(bType_) == WT::Reflected);
+    Ext::Assert<Ext::UserError>(!problem, "--operation inverse takes one --filter and periodic coefficients, without --manifest");
+    problem = (op_ == CONTAINER || op_ == SPARSE) && WT::selectBoundary(bType_) == WT::Reflected;
+    Ext::Assert<Ext::UserError>(!problem, "--operation container and sparse write periodic coefficients only ; see --boundary");
+    problem = binary_ && (op_ == WAVE_COEFFS || op_ == SCALE_COEFFS || op_ == WAVE_SCALE_COEFFS) &&
+              WT::selectBoundary(bType_) == WT::Reflected;
+    Ext::Assert<Ext::UserError>(!problem, "--binary coefficients are for --operation inverse, which needs a periodic --boundary");
+    problem = filters_.size() > 1 && (matrix_ || tracks || table || !pyramid_.empty() || (toStdout_ && op_ != VARIANCE));
+    Ext::Assert<Ext::UserError>(!problem, "several --filter's may not be used with --input-format, --matrix or --pyramid, nor with --to-stdout unless --operation variance");
   }
 
   std::string Input::lc(const std::string& s) {
@@ -288,14 +1685,151 @@ namespace {
     return(cpy);
   }
 
-  void Input::setLevel(const std::string& s) {
+  int Input::toPlusInt(const std::string& s) {
     static const std::string plusInts = "0123456789";
     std::string::size_type sz = s.find_first_not_of(plusInts);
     std::string::size_type npos = std::string::npos;
     Ext::Assert<Ext::UserError>(sz == npos, "Not a +integer", s);
+    int val = 0;
     std::stringstream converter(s);
-    converter >> maxLevel_;
-    Ext::Assert<Ext::UserError>(maxLevel_ > 0, "Not a +integer", s);
+    converter >> val;
+    Ext::Assert<Ext::UserError>(val > 0, "Not a +integer", s);
+    return(val);
+  }
+
+  double Input::toPlusNum(const std::string& s) {
+    char* end = 0;
+    double val = std::strtod(s.c_str(), &end);
+    Ext::Assert<Ext::UserError>(!s.empty() && *end == '\0' && val > 0, "Not a +number", s);
+    return(val);
+  }
+
+  void Input::setIOBackend(const std::string& s) {
+    std::string b = lc(s);
+    if ( b == "auto" )
+      ioBackend_ = WT::WriterOptions::AUTO;
+    else if ( b == "io_uring" )
+      ioBackend_ = WT::WriterOptions::IO_URING;
+    else if ( b == "pwrite" )
+      ioBackend_ = WT::WriterOptions::PWRITE;
+    else
+      throw(Ext::UserError("Unknown --io-backend: " + s, "expect auto, io_uring or pwrite"));
+  }
+
+  void Input::setOutputBin(const std::string& s) {
+    if ( lc(s) == "auto" ) // 2^j per level
+      binAuto_ = true, outputBin_ = 0;
+    else
+      binAuto_ = false, outputBin_ = static_cast<std::size_t>(toPlusInt(s));
+  }
+
+  void Input::setOutputBinStat(const std::string& s) {
+    std::string b = lc(s);
+    if ( b == "mean" )
+      binStat_ = WT::PrintValues::MEAN;
+    else if ( b == "min" )
+      binStat_ = WT::PrintValues::MIN;
+    else if ( b == "max" )
+      binStat_ = WT::PrintValues::MAX;
+    else if ( b == "sample" )
+      binStat_ = WT::PrintValues::SAMPLE;
+    else
+      throw(Ext::UserError("Unknown --output-bin-stat: " + s, "expect mean, min, max or sample"));
+  }
+
+  void Input::setRegion(const std::string& s) {
+    // a:b -> positions [a, b) counting from 0
+    std::string::size_type colon = s.find(':');
+    Ext::Assert<Ext::UserError>(colon != std::string::npos, "Expect a:b for --region", s);
+    std::string a = s.substr(0, colon);
+    regionFirst_ = (a == "0") ? 0 : static_cast<std::size_t>(toPlusInt(a));
+    regionLast_ = static_cast<std::size_t>(toPlusInt(s.substr(colon + 1)));
+    Ext::Assert<Ext::UserError>(regionFirst_ < regionLast_, "Empty --region", s);
+  }
+
+  void Input::setFilter(const std::string& s) {
+    // 'all' or a comma-separated list ; names are kept in lower case as output tags
+    std::list<std::string> known = WT::Filter::allFTypesStrings();
+    std::vector<std::string> all;
+    for ( std::list<std::string>::const_iterator i = known.begin(); i != known.end(); ++i )
+      all.push_back(lc(*i));
+
+    filters_.clear();
+    if ( lc(s) == "all" )
+      filters_ = all;
+    else {
+      std::stringstream names(s);
+      std::string name;
+      while ( std::getline(names, name, ',') ) {
+        name = lc(name);
+        Ext::Assert<Ext::UserError>(std::find(all.begin(), all.end(), name) != all.end(), "Unknown --filter: " + name);
+        Ext::Assert<Ext::UserError>(std::find(filters_.begin(), filters_.end(), name) == filters_.end(),
+                                    "--filter lists " + name + " twice");
+        filters_.push_back(name);
+      } // while
+    }
+    Ext::Assert<Ext::UserError>(!filters_.empty(), "Empty --filter list");
+    fType_ = filters_[0];
+    filterGiven_ = true;
+  }
+
+  Input Input::ForFilter(const std::string& filter) const {
+    Input one(*this);
+    one.fType_ = filter;
+    one.filters_.assign(1, filter);
+    one.prefix_ += filter + ".";
+    return(one);
+  }
+
+  void Input::setLevel(const std::string& s)
+    { maxLevel_ = toPlusInt(s); }
+
+  void Input::setLevels(const std::string& s) {
+    // comma-separated: j, a-b, a- (through --level) or smooth
+    std::stringstream all(s);
+    std::string item;
+    while ( std::getline(all, item, ',') ) {
+      if ( lc(item) == "smooth" ) {
+        levelsSmooth_ = true;
+        continue;
+      }
+      std::string::size_type dash = item.find('-');
+      int first = toPlusInt(item.substr(0, dash)), last = first;
+      if ( dash != std::string::npos )
+        last = (dash + 1 == item.size()) ? maxLevel_ : toPlusInt(item.substr(dash + 1));
+      Ext::Assert<Ext::UserError>(first <= last && last <= maxLevel_, "--levels must lie within 1..--level", item);
+      for ( int j = first; j <= last; ++j )
+        levels_.push_back(j);
+    } // while
+    std::sort(levels_.begin(), levels_.end());
+    levels_.erase(std::unique(levels_.begin(), levels_.end()), levels_.end());
+    Ext::Assert<Ext::UserError>(levelsSmooth_ || !levels_.empty(), "Empty --levels", s);
+  }
+
+  void Input::setNodes(const std::string& s) {
+    // comma-separated level.index pairs, such as 2.0,3.2,3.3,1.1
+    std::stringstream all(s);
+    std::string node;
+    while ( std::getline(all, node, ',') ) {
+      std::string::size_type dot = node.find('.');
+      Ext::Assert<Ext::UserError>(dot != std::string::npos, "Expect level.index in --nodes", node);
+      std::string idx = node.substr(dot + 1);
+      int index = (idx == "0") ? 0 : toPlusInt(idx);
+      int level = toPlusInt(node.substr(0, dot));
+      Ext::Assert<Ext::UserError>(level < 31 && index < (1 << level), "No such packet node", node);
+      nodes_.Add(level, index);
+    } // while
+    Ext::Assert<Ext::UserError>(!nodes_.Empty(), "Empty --nodes list");
+  }
+
+  void Input::setWith(const std::string& s) {
+    std::stringstream all(s);
+    std::string file;
+    while ( std::getline(all, file, ',') ) {
+      if ( !file.empty() )
+        with_.push_back(file);
+    } // while
+    Ext::Assert<Ext::UserError>(!with_.empty(), "Empty --with list");
   }
 
   void Input::setOperation(const std::string& s) {
@@ -308,12 +1842,36 @@ namespace {
       op_ = WAVE_SCALE_COEFFS;
     else if ( op == "smooth" )
       op_ = SMOOTH;
+    else if ( op == "inverse" )
+      op_ = INVERSE;
+    else if ( op == "sparse" )
+      op_ = SPARSE;
+    else if ( op == "container" )
+      op_ = CONTAINER;
+    else if ( op == "smooths" )
+      op_ = SMOOTHS;
+    else if ( op == "denoise" )
+      op_ = DENOISE;
     else if ( op == "details" )
       op_ = DETAILS;
     else if ( op == "mra" )
       op_ = MRA;
     else if ( op == "all" )
       op_ = ALL;
+    else if ( op == "dwt" )
+      op_ = DWT_COEFFS;
+    else if ( op == "dwt-mra" )
+      op_ = DWT_MRA;
+    else if ( op == "packets" )
+      op_ = PACKETS;
+    else if ( op == "peaks" )
+      op_ = PEAKS;
+    else if ( op == "variance" )
+      op_ = VARIANCE;
+    else if ( op == "xcorr" )
+      op_ = XCORR;
+    else if ( op == "bandpass" )
+      op_ = BANDPASS;
     else
       throw(Ext::UserError("Unknown --operation: " + s, allowedOps()));
   }
@@ -321,12 +1879,24 @@ namespace {
   std::string Input::allowedOps() {
     std::string val = "\n\tAllowed --operation list:\n";
     val += "\t\tall\n";
+    val += "\t\tbandpass (the sum of the --levels details, and smooth, from one inverse)\n";
+    val += "\t\tcontainer (wave-scale coefficients in one binary file, for inverse)\n";
+    val += "\t\tdenoise (threshold wavelet coefficients, then invert)\n";
     val += "\t\tdetails\n";
+    val += "\t\tdwt (decimated wavelet and scaling coefficients)\n";
+    val += "\t\tdwt-mra (decimated details and smooth)\n";
+    val += "\t\tinverse (the series back from container, --binary wave-scale or sparse output)\n";
     val += "\t\tmra\n";
+    val += "\t\tpackets (wavelet packet coefficients)\n";
+    val += "\t\tpeaks (extrema of the details and smooth, linked across levels)\n";
     val += "\t\tscale\n";
     val += "\t\tsmooth\n";
+    val += "\t\tsmooths (the smooth of every level 1..--level)\n";
+    val += "\t\tsparse (the largest wavelet coefficients only, per --top-k and --min-magnitude)\n";
+    val += "\t\tvariance (wavelet variance per level with 95% confidence intervals)\n";
     val += "\t\twave\n";
     val += "\t\twave-scale\n";
+    val += "\t\txcorr (wavelet cross-covariance and correlation against --with series)\n";
     return(val);
   }
 
@@ -360,13 +1930,39 @@ namespace {
 
   std::string Input::Usage() {
     std::string expect = "modwt";
+    expect += "\n\t[--binary]";
     expect += "\n\t[--boundary <string = periodic>]";
-    expect += "\n\t[--filter <string = LA8>]";
+    expect += "\n\t[--filter <string,... | all = LA8>]";
     expect += "\n\t[--help (includes option details)]";
+    expect += "\n\t[--input-format <string = column>]";
+    expect += "\n\t[--io-backend <string = auto>]";
     expect += "\n\t[--level <integer = 4>]";
+    expect += "\n\t[--levels <j,a-b,a-,smooth,...>]";
+    expect += "\n\t[--manifest]";
+    expect += "\n\t[--matrix]";
+    expect += "\n\t[--max-lag <integer = 0>]";
+    expect += "\n\t[--min-magnitude <number>]";
+    expect += "\n\t[--nodes <level.index,... = all at --level>]";
     expect += "\n\t[--operation <string = smooth>]";
+    expect += "\n\t[--output-bin <integer | auto>]";
+    expect += "\n\t[--output-bin-stat <string = mean>]";
+    expect += "\n\t[--peak-high <number>]";
+    expect += "\n\t[--peak-low <number = peak-high/2>]";
     expect += "\n\t[--prefix <string = ''>]";
+    expect += "\n\t[--pyramid <file-name>]";
+    expect += "\n\t[--queue-depth <integer = 8>]";
+    expect += "\n\t[--region <integer:integer>]";
+    expect += "\n\t[--row-band <integer>]";
+    expect += "\n\t[--runs]";
+    expect += "\n\t[--shrink <string = soft>]";
+    expect += "\n\t[--threads <integer = all cores>]";
+    expect += "\n\t[--threshold <string = universal>]";
     expect += "\n\t[--to-stdout]";
+    expect += "\n\t[--top-k <integer>]";
+    expect += "\n\t[--top-k-global]";
+    expect += "\n\t[--window <integer>]";
+    expect += "\n\t[--window-step <integer = 1>]";
+    expect += "\n\t[--with <file-name,...>]";
     expect += "\n\t<file-name>";
     expect += "\n";
     return(expect);
@@ -375,9 +1971,69 @@ namespace {
   std::string Input::VerboseUsage() {
     std::string verbose = Usage();
     verbose += "\n";
+    verbose += "\n\t--binary writes values in native binary form instead of text.  Binary wave,";
+    verbose += "\n\t  scale or wave-scale coefficients need a periodic --boundary\n";
+    verbose += "\n\t--filter may list several filters, comma-separated, or be all.  The input";
+    verbose += "\n\t  is read once and each filter's output names start with <filter>.  wave,";
+    verbose += "\n\t  scale, wave-scale and variance share one pass over the input, and variance";
+    verbose += "\n\t  gives one table with a filter column\n";
+    verbose += "\n\t--input-format is column (one value per line), table, bedgraph or wig.  A table";
+    verbose += "\n\t  holds one equal-length series per whitespace-separated column, all";
+    verbose += "\n\t  transformed together, and each output file is a table with the same";
+    verbose += "\n\t  columns.  --operation = wave|scale|wave-scale.  bedGraph";
+    verbose += "\n\t  and WIG input may hold many chromosomes, which are transformed in parallel";
+    verbose += "\n\t  as runs (see --runs).  Uncovered stretches count as zeros.  Output is";
+    verbose += "\n\t  bedGraph\n";
+    verbose += "\n\t--io-backend is one of auto, io_uring or pwrite.  auto uses io_uring when";
+    verbose += "\n\t  the kernel allows it and a pool of pwrite() threads otherwise.  io_uring";
+    verbose += "\n\t  is an error where the kernel does not allow it\n";
     verbose += "\n\t--level is the max level to compute to\n";
+    verbose += "\n\t--levels picks the details summed by --operation bandpass: single levels,";
+    verbose += "\n\t  ranges a-b, a- (through --level) and smooth for the --level smooth.  With";
+    verbose += "\n\t  --operation = all|details|mra|wave|wave-scale, only the listed levels'";
+    verbose += "\n\t  wavelet coefficients and details are computed and written\n";
+    verbose += "\n\t--manifest reads <file-name> as a list of jobs, one per line: an input file,";
+    verbose += "\n\t  an output prefix and, optionally, more options for that job alone, separated";
+    verbose += "\n\t  by tabs.  Jobs run in parallel (see --threads), largest input first.";
+    verbose += "\n\t  --binary, --io-backend and --queue-depth may only be given on the command line\n";
+    verbose += "\n\t--matrix reads a 2D matrix, one row per line, and applies the 2D MODWT.";
+    verbose += "\n\t  Applicable to --operation = wave|scale|wave-scale|mra\n";
+    verbose += "\n\t--max-lag is the largest lag, either way, for --operation xcorr\n";
+    verbose += "\n\t--min-magnitude keeps only wavelet coefficients with |value| above it for";
+    verbose += "\n\t  --operation sparse\n";
+    verbose += "\n\t--nodes picks the packet nodes output by --operation packets, such as";
+    verbose += "\n\t  a best basis: 2.0,3.2,3.3,1.1.  Only their ancestors are computed\n";
+    verbose += "\n\t--output-bin writes one value per bin of this many values, or of 2^j values";
+    verbose += "\n\t  at level j when auto, for coarse views of long series.  --output-bin-stat";
+    verbose += "\n\t  picks the value: the mean, min or max of the bin, or its first (sample)\n";
+    verbose += "\n\t--peak-high starts an extremum for --operation peaks once |value| reaches it,";
+    verbose += "\n\t  and --peak-low ends it once |value| falls below that\n";
     verbose += "\n\t--prefix is added to front of each output file name\n";
-    verbose += "\n\t--to-stdout is applicable to --operation = scale|smooth";
+    verbose += "\n\t--pyramid also writes min/max/mean/sum-of-squares summaries of every output";
+    verbose += "\n\t  file, over tiles of 64, 256, 1024, ... values, to this indexed file\n";
+    verbose += "\n\t--queue-depth is the number of writes in flight per output stream\n";
+    verbose += "\n\t--region a:b outputs positions a through b-1 only (counting from 0), computing";
+    verbose += "\n\t  just the part of the transform they depend on.  --operation =";
+    verbose += "\n\t  details|mra|scale|smooth|wave|wave-scale\n";
+    verbose += "\n\t--row-band keeps a --matrix on disk and transforms it this many rows at";
+    verbose += "\n\t  a time, for matrices too large for memory\n";
+    verbose += "\n\t--runs transforms the input as runs of equal values, and writes each output";
+    verbose += "\n\t  file as lines of 'start end value' (end exclusive).  Much faster for input";
+    verbose += "\n\t  with long constant or zero stretches\n";
+    verbose += "\n\t--shrink is soft or hard shrinkage of coefficients for --operation denoise\n";
+    verbose += "\n\t--threads is the number of chromosomes (--input-format) or jobs (--manifest)";
+    verbose += "\n\t  transformed at once\n";
+    verbose += "\n\t--threshold is universal or sure, chosen per level for --operation denoise.";
+    verbose += "\n\t  The noise level comes from the MAD of the level 1 wavelet coefficients\n";
+    verbose += "\n\t--to-stdout is applicable to --operation = bandpass|denoise|inverse|peaks|scale|smooth|sparse|variance|xcorr\n";
+    verbose += "\n\t--top-k keeps the k largest-magnitude wavelet coefficients of each level for";
+    verbose += "\n\t  --operation sparse.  With --top-k-global they are the largest over all";
+    verbose += "\n\t  levels.  The --level scaling coefficients are always kept whole\n";
+    verbose += "\n\t--window writes the mean square of each level's values over a sliding window";
+    verbose += "\n\t  of this size, instead of the values.  --operation = wave|details\n";
+    verbose += "\n\t--window-step writes one windowed value per this many inputs\n";
+    verbose += "\n\t--with lists the series, each as long as <file-name>, that --operation xcorr";
+    verbose += "\n\t  pairs with <file-name>.  <file-name> is transformed only once.";
     verbose += "\n";
     verbose += allowedOps();
     verbose += "\n";
@@ -0,0 +1,71 @@
+#!/bin/sh
+#
+#  FILE: inverse_roundtrip.sh
+#  Runs each forward transform that --operation inverse reads (container,
+#   --binary wave-scale and sparse), inverts its output, and compares the
+#   result to the input.  Reflected-boundary runs, whose coefficients can
+#   not be inverted, and a --filter that differs from the recorded one must
+#   be refused.
+#
+#  usage: inverse_roundtrip.sh <modwt binary>
+#
+
+BIN=$1
+ROWS=1000
+LEVEL=5
+TOL=0.001
+[ -x "$BIN" ] || { echo "usage: $0 <modwt binary>" >&2; exit 1; }
+BIN=$(cd "$(dirname "$BIN")" && pwd)/$(basename "$BIN")
+
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+awk -v rows=$ROWS 'BEGIN {
+  srand(11);
+  for ( t = 0; t < rows; ++t )
+    printf("%.4f\n", 50 + 20 * sin(t / 40) + rand() * 10);
+}' > x.txt
+
+# same <name> as x.txt, value by value, within TOL
+same() {
+  [ "$(wc -l < "$1")" -eq $ROWS ] || { echo "FAIL: $1 has the wrong length" >&2; exit 1; }
+  paste x.txt "$1" | awk -v tol=$TOL '{ d = $1 - $2; if ( d < 0 ) d = -d; if ( d > tol ) bad = 1 }
+                                       END { exit bad }' || { echo "FAIL: $1 differs from the input" >&2; exit 1; }
+}
+
+# the command must fail
+refused() {
+  if "$@" > /dev/null 2>&1; then
+    echo "FAIL: not refused: $*" >&2
+    exit 1
+  fi
+}
+
+for f in la8 haar d4; do
+  "$BIN" --operation container --level $LEVEL --filter $f --prefix c.$f. x.txt || { echo "FAIL: container $f" >&2; exit 1; }
+  "$BIN" --operation inverse --to-stdout c.$f.coefficients.modwt > c.$f.out || { echo "FAIL: inverse container $f" >&2; exit 1; }
+  same c.$f.out
+
+  mkdir b.$f && cd b.$f || exit 1
+  "$BIN" --binary --operation wave-scale --level $LEVEL --filter $f ../x.txt || { echo "FAIL: binary $f" >&2; exit 1; }
+  "$BIN" --operation inverse --filter $f --to-stdout scaling-coefficients.$LEVEL > ../b.$f.out || { echo "FAIL: inverse binary $f" >&2; exit 1; }
+  cd .. || exit 1
+  same b.$f.out
+
+  # every nonzero coefficient is kept, so the sparse inverse is exact too
+  "$BIN" --operation sparse --min-magnitude 1e-30 --level $LEVEL --filter $f --prefix s.$f. x.txt || { echo "FAIL: sparse $f" >&2; exit 1; }
+  "$BIN" --operation inverse --to-stdout s.$f.sparse-coefficients > s.$f.out || { echo "FAIL: inverse sparse $f" >&2; exit 1; }
+  same s.$f.out
+done
+
+refused "$BIN" --operation container --boundary reflected --level $LEVEL x.txt
+refused "$BIN" --operation sparse --top-k 10 --boundary reflected --level $LEVEL x.txt
+refused "$BIN" --binary --operation wave-scale --boundary reflected --level $LEVEL x.txt
+refused "$BIN" --operation inverse --filter la8 c.d4.coefficients.modwt
+refused "$BIN" --operation inverse --filter la8 s.d4.sparse-coefficients
+refused "$BIN" --operation inverse b.la8/wavelet-coefficients.1
+cp x.txt scaling-coefficients.$LEVEL
+refused "$BIN" --operation inverse scaling-coefficients.$LEVEL
+
+echo "inverse_roundtrip: ok"
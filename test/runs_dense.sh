@@ -0,0 +1,48 @@
+#!/bin/sh
+#
+#  FILE: runs_dense.sh
+#  Transforms a piecewise-constant series with and without --runs, expands
+#   each 'start end value' line of the --runs output back to one value per
+#   position, and checks that it matches the dense output byte for byte.
+#
+#  usage: runs_dense.sh <modwt binary>
+#
+
+BIN=$1
+LEVEL=4
+[ -x "$BIN" ] || { echo "usage: $0 <modwt binary>" >&2; exit 1; }
+BIN=$(cd "$(dirname "$BIN")" && pwd)/$(basename "$BIN")
+
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+awk 'BEGIN {
+  srand(5);
+  for ( r = 0; r < 60; ++r ) {
+    v = int(rand() * 3) * int(rand() * 20);
+    n = 1 + int(rand() * 80);
+    for ( i = 0; i < n; ++i )
+      print v;
+  }
+}' > x.txt
+
+for op in all wave-scale details smooth mra; do
+  for boundary in periodic reflected; do
+    for f in haar d4 la8; do
+      rm -rf dense runs && mkdir dense runs || exit 1
+      (cd dense && "$BIN" --operation $op --boundary $boundary --filter $f --level $LEVEL ../x.txt) ||
+        { echo "FAIL: dense $op $boundary $f" >&2; exit 1; }
+      (cd runs && "$BIN" --runs --operation $op --boundary $boundary --filter $f --level $LEVEL ../x.txt) ||
+        { echo "FAIL: runs $op $boundary $f" >&2; exit 1; }
+      [ "$(ls dense)" = "$(ls runs)" ] || { echo "FAIL: $op $boundary $f: different output files" >&2; exit 1; }
+      for file in dense/*; do
+        name=$(basename "$file")
+        awk -F'\t' '{ for ( i = $1; i < $2; ++i ) print $3 }' runs/$name | cmp -s - "$file" ||
+          { echo "FAIL: $op $boundary $f: $name" >&2; exit 1; }
+      done
+    done
+  done
+done
+
+echo "runs_dense: ok"